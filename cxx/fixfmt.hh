@@ -6,4 +6,9 @@
 #include "fixfmt/string.hh"
 #include "fixfmt/time.hh"
 #include "fixfmt/date.hh"
+#include "fixfmt/arrow.hh"
+#include "fixfmt/filter.hh"
+#include "fixfmt/sort.hh"
+#include "fixfmt/duration.hh"
+#include "fixfmt/tz.hh"
 
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "fixfmt/string.hh"
+#include "fixfmt/table.hh"
+
+//------------------------------------------------------------------------------
+// Arrow C Data Interface
+//
+// The struct definitions are part of the stable ABI, and are copied verbatim
+// from the specifications, so that we don't depend on Arrow.  See
+// https://arrow.apache.org/docs/format/CDataInterface.html and
+// https://arrow.apache.org/docs/format/CStreamInterface.html.
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+}  // extern "C"
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+extern "C" {
+
+struct ArrowArrayStream {
+  // Callbacks providing stream functionality
+  int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+  int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+  const char* (*get_last_error)(struct ArrowArrayStream*);
+
+  // Release callback
+  void (*release)(struct ArrowArrayStream*);
+
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+}  // extern "C"
+
+#endif  // ARROW_C_STREAM_INTERFACE
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+using std::string;
+using std::unique_ptr;
+
+/*
+ * Returns buffer `i` of an Arrow array, as `TYPE`.
+ */
+template<typename TYPE>
+inline TYPE const*
+get_arrow_buffer(
+  ArrowArray const& array,
+  int const i)
+{
+  assert(i < array.n_buffers);
+  return reinterpret_cast<TYPE const*>(array.buffers[i]);
+}
+
+
+/*
+ * Returns the validity bitmap of an Arrow array, or null if all entries are
+ * valid.  Bits are offset by the array's offset.
+ */
+inline uint8_t const*
+get_arrow_validity(
+  ArrowArray const& array)
+{
+  return
+      array.null_count == 0 || array.n_buffers == 0 ? nullptr
+    : get_arrow_buffer<uint8_t>(array, 0);
+}
+
+
+/*
+ * Wraps `column` in a `NullableColumn` for the validity bitmap of `array`,
+ * if it has nulls.
+ */
+inline unique_ptr<Column>
+make_arrow_nullable(
+  ArrowArray const& array,
+  unique_ptr<Column> column,
+  string const& null="",
+  float const pad_pos=PAD_POS_LEFT_JUSTIFY)
+{
+  uint8_t const* const validity = get_arrow_validity(array);
+  if (validity == nullptr)
+    return column;
+  else
+    return std::make_unique<NullableColumn>(
+      std::move(column), validity, NullableColumn::MASK_VALID_BITS,
+      array.offset, null, pad_pos);
+}
+
+
+/*
+ * Returns a column of the values of a fixed-width primitive Arrow array,
+ * such as int64 or timestamp, without nulls.  The values are not copied.
+ */
+template<typename TYPE, typename FMT>
+inline unique_ptr<Column>
+make_arrow_primitive_column(
+  ArrowArray const& array,
+  FMT const& format)
+{
+  return std::make_unique<ColumnImpl<TYPE, FMT>>(
+    get_arrow_buffer<TYPE>(array, 1) + array.offset, array.length, format);
+}
+
+
+/*
+ * Returns a column of the values of an Arrow boolean array, which are
+ * bit-packed, without nulls.
+ */
+inline unique_ptr<Column>
+make_arrow_bool_column(
+  ArrowArray const& array,
+  Bool const& format)
+{
+  return std::make_unique<BitBoolColumn>(
+    get_arrow_buffer<uint8_t>(array, 1), array.offset, array.length, format,
+    true);
+}
+
+
+/*
+ * A column of Arrow variable-length UTF-8 strings.
+ *
+ * Entry `index` is the bytes of `data` from `offsets[offset + index]` to
+ * `offsets[offset + index + 1]`.  `OFFSET` is `int32_t` for the utf8 type and
+ * `int64_t` for large_utf8.
+ */
+template<typename OFFSET>
+class ArrowStringColumn
+  : public Column
+{
+public:
+
+  ArrowStringColumn(
+    OFFSET const* const offsets,
+    char const* const data,
+    long const offset,
+    long const length,
+    String format)
+  : offsets_(offsets + offset),
+    data_(data),
+    length_(length),
+    format_(std::move(format))
+  {
+    // Strings may contain escape sequences, so bound the bytes by the
+    // largest string, not by the width.
+    size_t max_size = 0;
+    for (long i = 0; i < length_; ++i)
+      max_size = std::max(max_size, (size_t) (offsets_[i + 1] - offsets_[i]));
+    max_bytes_ = format_.get_max_bytes(max_size);
+  }
+
+  ArrowStringColumn(
+    ArrowArray const& array,
+    String format)
+  : ArrowStringColumn(
+      get_arrow_buffer<OFFSET>(array, 1), get_arrow_buffer<char>(array, 2),
+      array.offset, array.length, std::move(format))
+  {
+  }
+
+  virtual ~ArrowStringColumn() override {}
+
+  virtual int get_width() const override { return format_.get_width(); }
+
+  virtual long get_length() const override { return length_; }
+
+  virtual int get_max_bytes() const override { return max_bytes_; }
+
+  virtual string
+  operator()(
+    long const index)
+    const override
+  {
+    assert(0 <= index && index < length_);
+    auto const start = offsets_[index];
+    return format_(string(data_ + start, offsets_[index + 1] - start));
+  }
+
+private:
+
+  OFFSET const* const offsets_;
+  char const* const data_;
+  long const length_;
+  String const format_;
+  int max_bytes_;
+
+};
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
@@ -1,5 +1,29 @@
 #pragma once
 
+#include <cstring>
+
 template<typename T>
 inline void unused(T const&) {}
 
+namespace fixfmt {
+
+/*
+ * Loads element `index` of an array whose elements are `stride` bytes apart,
+ * starting at `base`.  The stride may be negative, and elements need not be
+ * aligned, as in a field of a packed record array.
+ */
+template<typename TYPE>
+inline TYPE
+load_strided(
+  void const* const base,
+  long const stride,
+  long const index)
+{
+  TYPE val;
+  memcpy(&val, static_cast<char const*>(base) + index * stride, sizeof(TYPE));
+  return val;
+}
+
+
+}  // namespace fixfmt
+
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 
@@ -59,9 +60,18 @@ public:
     { check(args); args_ = std::move(args); set_up(); }
 
   size_t get_width() const noexcept { return args_.size; }
-  string operator()(bool const val) const
+  string const& operator()(bool const val) const
     { return val ? true_ : false_; }
 
+  /*
+   * The formatted true and false values.
+   */
+  string const& get_true() const noexcept { return true_; }
+  string const& get_false() const noexcept { return false_; }
+
+  size_t get_max_bytes() const noexcept
+    { return std::max(true_.size(), false_.size()); }
+
 private:
 
   static void check(Args const&) {}
@@ -1,32 +1,83 @@
-#include <cassert>
-#include <ctime>
-#include <iostream>
+#include <cstring>
 
 #include "date.hh"
+#include "digits.hh"
 
 //------------------------------------------------------------------------------
 
 namespace fixfmt {
 
-string 
-TickDate::operator()(
-  long val) 
-  const 
+char*
+TickDate::format_arithmetic(
+  long const val,
+  char* const out)
+  const
 {
-  // FIXME: Validate range.
+  if (val == NAT_VALUE) {
+    memcpy(out, nat_.data(), nat_.size());
+    return out + nat_.size();
+  }
+  if (val < get_val_min(unit_) || get_val_max(unit_) < val) {
+    memcpy(out, bad_result_.data(), width_);
+    return out + width_;
+  }
+
+  long year;
+  unsigned month = 1, day = 1;
+  switch (unit_) {
+  case UNIT_YEAR:
+    year = 1970 + val;
+    break;
+
+  case UNIT_MONTH:
+    // Months since 1970-01; nonnegative after shifting to 0000-01.
+    year = (val + 1970 * 12) / 12;
+    month = (val + 1970 * 12) % 12 + 1;
+    break;
+
+  case UNIT_WEEK:
+    days_to_civil(val * 7, year, month, day);
+    break;
+
+  default:
+    days_to_civil(val, year, month, day);
+    break;
+  }
+
+  write2(out    , year / 100);
+  write2(out + 2, year % 100);
+  if (unit_ != UNIT_YEAR) {
+    out[4] = '-';
+    write2(out + 5, month);
+  }
+  if (width_ == 10) {
+    out[7] = '-';
+    write2(out + 8, day);
+  }
+  return out + width_;
+}
+
 
-  time_t const whole = 86400 * val;
-  struct tm time;
-  if (gmtime_r(&whole, &time) == NULL) 
-    return "####-##-##";
+void
+TickDate::format(
+  long const* const vals,
+  long const num,
+  char** const pos)
+  const
+{
+  for (long i = 0; i < num; ++i)
+    pos[i] = format(vals[i], pos[i]);
+}
 
-  // Render the time in whole seconds.
-  char buf[] = "??????????";
-  size_t const pos = strftime(buf, 11, "%Y-%m-%d", &time);
-  if (pos != 10)
-    return "####-##-##";
 
-  return buf;
+string 
+TickDate::operator()(
+  long const val) 
+  const 
+{
+  string result(get_max_bytes(), ' ');
+  result.resize(format(val, &result[0]) - &result[0]);
+  return result;
 }
 
 
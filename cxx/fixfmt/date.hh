@@ -1,35 +1,207 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstring>
 #include <string>
 
 #include "math.hh"
+#include "text.hh"
 
 //------------------------------------------------------------------------------
 
-// FIXME: This is a kind of hacky placeholder implementation until we have a
-// proper date implementation to work with.
-
 namespace fixfmt {
 
 using std::string;
 
+/*
+ * Range of days since 1970-01-01 whose years are 0000 through 9999, which
+ * are the years that render in four digits.
+ */
+constexpr long DAY_MIN = -719528l;
+constexpr long DAY_MAX =  2932896l;
+
+/*
+ * Converts days since 1970-01-01 to a proleptic Gregorian year, month, and
+ * day, in pure arithmetic.  `days` must not be before 0000-01-01.
+ *
+ * This is Howard Hinnant's `civil_from_days`, with the origin shifted by one
+ * 400-year era so that all intermediate values are nonnegative.
+ */
+inline void
+days_to_civil(
+  long const days,
+  long& year,
+  unsigned& month,
+  unsigned& day)
+  noexcept
+{
+  // Days since 0000-03-01 minus one era; the leap day is then the last day
+  // of the year.
+  unsigned long const z = days + 719468 + 146097;
+  unsigned long const era = z / 146097;
+  unsigned const doe = z - era * 146097;
+  unsigned const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  unsigned const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  unsigned const mp = (5 * doy + 2) / 153;
+  day = doy - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year = (long) yoe + (long) era * 400 - 400 + (month <= 2);
+}
+
+
+/*
+ * Converts a proleptic Gregorian date to days since 1970-01-01; the inverse
+ * of `days_to_civil`.  `year` must not be before 0000.
+ */
+inline long
+civil_to_days(
+  long year,
+  unsigned const month,
+  unsigned const day)
+  noexcept
+{
+  year -= month <= 2;
+  // Shifted by one era, as above.
+  unsigned long const era = (year + 400) / 400;
+  unsigned const yoe = year + 400 - era * 400;
+  unsigned const doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5
+    + day - 1;
+  unsigned const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return (long) era * 146097 + doe - 719468 - 146097;
+}
+
+
 class TickDate
 {
 public:
 
   constexpr static int PRECISION_NONE = -1;
 
-  TickDate()
+  /*
+   * The tick value of numpy's NaT, as for `TickTime`.
+   */
+  constexpr static long NAT_VALUE = -9223372036854775807l - 1;
+
+  /*
+   * Units of ticks, as in numpy.datetime64.  Weeks render as the date of
+   * their first day, months as "YYYY-MM", and years as "YYYY".
+   */
+  constexpr static char UNIT_DAY    = 'D';
+  constexpr static char UNIT_WEEK   = 'W';
+  constexpr static char UNIT_MONTH  = 'M';
+  constexpr static char UNIT_YEAR   = 'Y';
+
+  /*
+   * Most values for which a lookup table is built.  For days, this covers
+   * about 180 years, in 640 KB.
+   */
+  constexpr static long TABLE_MAX_SIZE = 1l << 16;
+
+  /*
+   * If `min_val` through `max_val` is a nonempty range of at most
+   * `TABLE_MAX_SIZE` values, renders each value in it up front, so that
+   * these are formatted by copying.  Values outside the range are still
+   * formatted correctly, arithmetically.  `NAT_VALUE` renders as `nat`.
+   */
+  TickDate(
+    long    const  min_val=1,
+    long    const  max_val=0,
+    char    const  unit=UNIT_DAY,
+    string  const& nat="NaT")
+  : unit_(unit),
+    width_(unit == UNIT_YEAR ? 4 : unit == UNIT_MONTH ? 7 : 10),
+    bad_result_(string("####-##-##", width_)),
+    nat_(palide(nat, width_, "", " ", 1, PAD_POS_LEFT_JUSTIFY)),
+    table_min_(std::max(min_val, get_val_min(unit))),
+    table_num_(
+      std::min(max_val, get_val_max(unit)) < table_min_
+        || std::min(max_val, get_val_max(unit)) - table_min_ >= TABLE_MAX_SIZE
+      ? 0
+      : std::min(max_val, get_val_max(unit)) - table_min_ + 1)
+  {
+    assert(
+         unit == UNIT_DAY || unit == UNIT_WEEK 
+      || unit == UNIT_MONTH || unit == UNIT_YEAR);
+    table_.resize(table_num_ * width_);
+    for (unsigned long i = 0; i < table_num_; ++i)
+      format_arithmetic(table_min_ + i, &table_[i * width_]);
+  }
+
+  size_t    get_width()     const { return width_; }
+
+  char      get_unit()      const { return unit_; }
+  string const& get_nat()   const { return nat_; }
+
+  /*
+   * Returns the most bytes a formatted value may take.
+   */
+  size_t get_max_bytes() const { return std::max(width_, nat_.size()); }
+
+  /*
+   * The range of values in the lookup table; empty if there is none.
+   */
+  long      get_min_val()   const { return table_min_; }
+  long      get_max_val()   const { return table_min_ + table_num_ - 1; }
+
+  /*
+   * Formats `val` ticks since 1970-01-01 into `out`, which must have room
+   * for `get_max_bytes()` bytes.  Returns the end of the output.
+   */
+  char* format(long const val, char* const out) const
   {
+    // Subtract unsigned, as the difference may overflow a long.
+    unsigned long const i = (unsigned long) val - (unsigned long) table_min_;
+    if (i < table_num_) {
+      memcpy(out, &table_[i * width_], width_);
+      return out + width_;
+    }
+    else
+      return format_arithmetic(val, out);
   }
 
-  size_t    get_width()     const { return 10; }
+  /*
+   * Formats `num` values; value `i` is written at `pos[i]`, which is
+   * advanced past it.
+   */
+  void format(long const* vals, long num, char** pos) const;
 
   string operator()(long val) const;
 
 private:
 
+  /*
+   * The range of values in `unit` whose years are 0000 through 9999.
+   */
+  static long get_val_min(char const unit)
+  {
+    return 
+        unit == UNIT_YEAR  ? -1970
+      : unit == UNIT_MONTH ? -1970 * 12
+      : unit == UNIT_WEEK  ? -(-DAY_MIN / 7)
+      : DAY_MIN;
+  }
+
+  static long get_val_max(char const unit)
+  {
+    return 
+        unit == UNIT_YEAR  ? 9999 - 1970
+      : unit == UNIT_MONTH ? (9999 - 1970) * 12 + 11
+      : unit == UNIT_WEEK  ? DAY_MAX / 7
+      : DAY_MAX;
+  }
+
+  char* format_arithmetic(long val, char* out) const;
+
+  char          const unit_;
+  size_t        const width_;
+  string        const bad_result_;
+  string        const nat_;
+  long          const table_min_;
+  unsigned long const table_num_;
+  string              table_;
+
 };
 
 
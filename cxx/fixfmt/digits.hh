@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstring>
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+/*
+ * The two-digit decimal numbers "00" through "99", concatenated.
+ */
+constexpr char DIGITS2[201] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+
+/*
+ * Writes `val`, which must be less than 100, as two decimal digits.
+ */
+inline void
+write2(
+  char* const buf,
+  unsigned const val)
+  noexcept
+{
+  memcpy(buf, &DIGITS2[2 * val], 2);
+}
+
+
+/*
+ * Writes the last `num` decimal digits of `val`, zero-padded on the left.
+ */
+inline void
+write_digits(
+  char* const buf,
+  unsigned long val,
+  int num)
+  noexcept
+{
+  for (; num >= 2; num -= 2) {
+    write2(buf + num - 2, val % 100);
+    val /= 100;
+  }
+  if (num == 1)
+    buf[0] = '0' + val % 10;
+}
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
@@ -0,0 +1,171 @@
+#include <cassert>
+#include <cstring>
+
+#include "digits.hh"
+#include "duration.hh"
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+namespace {
+
+/*
+ * Returns the number of decimal digits in `val`.
+ */
+inline int
+num_digits(
+  unsigned long val)
+{
+  int digits = 1;
+  for (; val >= 10; val /= 10)
+    ++digits;
+  return digits;
+}
+
+
+}  // anonymous namespace
+
+
+char*
+TickDuration::format(
+  long const val,
+  char* const out)
+  const
+{
+  if (val == NAT_VALUE) {
+    memcpy(out, nat_.data(), nat_.size());
+    return out + nat_.size();
+  }
+  bool const negative = val < 0;
+  long const mag = negative ? -val : val;
+  if (mag > max_val_) {
+    memcpy(out, bad_result_.data(), width_);
+    return out + width_;
+  }
+
+  // Find the whole number of seconds, and the fractional seconds scaled up
+  // by pow10(precision), rounding the magnitude half away from zero.
+  long whole;
+  long frac;
+  if (period_ != 1) {
+    whole = mag * period_;
+    frac = 0;
+  }
+  else if (round_scale_) {
+    long const rounded = (mag + round_scale_ / 2) / round_scale_;
+    whole = rounded / prec_scale_;
+    frac = rounded % prec_scale_;
+  }
+  else {
+    whole = mag / scale_;
+    frac = (mag % scale_) * (prec_scale_ / scale_);
+  }
+
+  long const days = whole / 86400;
+  unsigned const secs = whole % 86400;
+  if (days >= max_days_) {
+    memcpy(out, bad_result_.data(), width_);
+    return out + width_;
+  }
+
+  if (style_ == STYLE_CLOCK) {
+    // Days, right-justified after the sign.
+    int const digits = num_digits(days);
+    memset(out, ' ', day_digits_ + 1 - digits);
+    if (negative)
+      out[day_digits_ - digits] = '-';
+    write_digits(out + day_digits_ + 1 - digits, days, digits);
+
+    char* p = out + day_digits_ + 1;
+    *p = ' ';
+    write2(p + 1, secs / 3600);
+    p[3] = ':';
+    write2(p + 4, secs / 60 % 60);
+    p[6] = ':';
+    write2(p + 7, secs % 60);
+    p += 9;
+    if (precision_ != PRECISION_NONE) {
+      *p++ = '.';
+      write_digits(p, frac, prec_);
+    }
+  }
+
+  else {
+    // Render the two largest units, then right-justify.
+    char buf[64];
+    char* p = buf;
+    if (negative)
+      *p++ = '-';
+    auto const unit = [&p](unsigned long const val, char const suffix) {
+      int const digits = num_digits(val);
+      write_digits(p, val, digits);
+      p += digits;
+      *p++ = suffix;
+    };
+    auto const unit2 = [&p](unsigned const val, char const suffix) {
+      write2(p, val);
+      p += 2;
+      *p++ = suffix;
+    };
+    if (days > 0) {
+      unit(days, 'd');
+      unit2(secs / 3600, 'h');
+    }
+    else if (secs >= 3600) {
+      unit(secs / 3600, 'h');
+      unit2(secs / 60 % 60, 'm');
+    }
+    else if (secs >= 60) {
+      unit(secs / 60, 'm');
+      unit2(secs % 60, 's');
+    }
+    else {
+      int const digits = num_digits(secs);
+      write_digits(p, secs, digits);
+      p += digits;
+      if (precision_ != PRECISION_NONE) {
+        *p++ = '.';
+        write_digits(p, frac, prec_);
+        p += prec_;
+      }
+      *p++ = 's';
+    }
+
+    size_t const len = p - buf;
+    assert(len <= width_);
+    memset(out, ' ', width_ - len);
+    memcpy(out + width_ - len, buf, len);
+  }
+
+  return out + width_;
+}
+
+
+void
+TickDuration::format(
+  long const* const vals,
+  long const num,
+  char** const pos)
+  const
+{
+  for (long i = 0; i < num; ++i)
+    pos[i] = format(vals[i], pos[i]);
+}
+
+
+string 
+TickDuration::operator()(
+  long const val) 
+  const 
+{
+  string result(get_max_bytes(), ' ');
+  result.resize(format(val, &result[0]) - &result[0]);
+  return result;
+}
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <string>
+
+#include "math.hh"
+#include "fixfmt/text.hh"
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+using std::string;
+
+/*
+ * Formatter for durations in integer ticks, such as numpy.timedelta64.
+ *
+ * In the clock style, durations are shown as "[-]D HH:MM:SS[.fff]", with
+ * days right-justified in `day_digits` digits.  In the compact style, they
+ * are shown with their two largest units, as "3d04h", "1h02m", "2m03s", or
+ * "3[.fff]s", right-justified.  Either way, one character is reserved for
+ * the sign.  Durations with more days than fit show as "#".
+ */
+class TickDuration
+{
+public:
+
+  constexpr static int STYLE_CLOCK      = 0;
+  constexpr static int STYLE_COMPACT    = 1;
+
+  // NaT ("not a time") value used by numpy.timedelta64.
+  constexpr static long NAT_VALUE = std::numeric_limits<long>::min();
+
+  constexpr static int PRECISION_NONE = -1;
+
+  /*
+   * Ticks are `1 / scale` seconds, or `period` seconds, as for `TickTime`.
+   */
+  TickDuration(
+    long    const  scale        =1,
+    int     const  precision    =PRECISION_NONE,
+    int     const  style        =STYLE_CLOCK,
+    int     const  day_digits   =1,
+    string  const& nat          ="NaT",
+    long    const  period       =1)
+  : scale_(scale),
+    period_(period),
+    precision_(precision),
+    style_(style),
+    day_digits_(day_digits),
+    width_(
+      1 + (
+          style == STYLE_CLOCK
+        ? day_digits + 9 + (precision == PRECISION_NONE ? 0 : 1 + precision)
+        : std::max(
+            std::max(day_digits + 4, 6),
+            3 + (precision == PRECISION_NONE ? 0 : 1 + precision)))),
+    bad_result_(width_, '#'),
+    nat_(palide(nat, width_, "", " ", 1, PAD_POS_RIGHT_JUSTIFY)),
+    prec_(precision_ == PRECISION_NONE ? 0 : precision_),
+    prec_scale_(pow10(prec_)),
+    round_scale_(scale_ > prec_scale_ ? scale_ / prec_scale_ : 0),
+    max_days_(pow10(day_digits)),
+    max_val_((std::numeric_limits<long>::max() - round_scale_) / period_)
+  {
+    assert(scale_ > 0);
+    assert(period_ > 0);
+    assert(scale_ == 1 || period_ == 1);
+    assert(style_ == STYLE_CLOCK || style_ == STYLE_COMPACT);
+    assert(0 < day_digits_ && day_digits_ < 19);
+  }
+
+  size_t        get_width()         const { return width_; }
+
+  long          get_scale()         const { return scale_; }
+  long          get_period()        const { return period_; }
+  int           get_precision()     const { return precision_; }
+  int           get_style()         const { return style_; }
+  int           get_day_digits()    const { return day_digits_; }
+  string const& get_nat()           const { return nat_; }
+
+  /*
+   * Returns the most bytes a formatted value may take.  Durations are
+   * ASCII, but the NaT text may not be.
+   */
+  size_t get_max_bytes() const { return std::max(width_, nat_.size()); }
+
+  /*
+   * Formats `val` into `out`, which must have room for `get_max_bytes()`
+   * bytes.  Returns the end of the output.
+   */
+  char* format(long val, char* out) const;
+
+  /*
+   * Formats `num` values; value `i` is written at `pos[i]`, which is
+   * advanced past it.
+   */
+  void format(long const* vals, long num, char** pos) const;
+
+  string operator()(long val) const;
+
+private:
+
+  long      const scale_;
+  long      const period_;
+  int       const precision_;
+  int       const style_;
+  int       const day_digits_;
+  size_t    const width_;
+  string    const bad_result_;
+  string    const nat_;
+
+  // Intermediate values used in formatting computation.
+  int       const prec_;
+  long      const prec_scale_;
+  long      const round_scale_;
+  long      const max_days_;
+  // Largest magnitude that can be converted without overflow.
+  long      const max_val_;
+
+};
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
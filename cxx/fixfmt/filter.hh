@@ -0,0 +1,487 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fixfmt/base.hh"
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+using std::string;
+using std::unique_ptr;
+
+/*
+ * A condition on rows, by which to select them.
+ */
+class Predicate
+{
+public:
+
+  virtual ~Predicate() = default;
+
+  /*
+   * Sets `out[i]` to 1 if row `begin + i` matches, 0 otherwise, for rows
+   * `begin` through `end`.
+   */
+  virtual void evaluate(long begin, long end, uint8_t* out) const = 0;
+
+};
+
+
+/*
+ * Comparison operators.
+ */
+enum class CompareOp
+{
+  EQ, NE, LT, LE, GT, GE,
+};
+
+
+/*
+ * Compares each of an array's values, each `stride` bytes apart, to `value`.
+ * Values are converted to `VALUE` to compare.
+ */
+template<typename TYPE, typename VALUE>
+class ComparePredicate
+  : public Predicate
+{
+public:
+
+  ComparePredicate(
+    TYPE const* const values,
+    CompareOp const op,
+    VALUE const value,
+    long const stride=sizeof(TYPE))
+  : values_(reinterpret_cast<char const*>(values)),
+    op_(op),
+    value_(value),
+    stride_(stride)
+  {
+  }
+
+  virtual ~ComparePredicate() override {}
+
+  virtual void
+  evaluate(
+    long const begin,
+    long const end,
+    uint8_t* const out)
+    const override
+  {
+    // Dispatch once, so that each loop is a simple kernel.
+    switch (op_) {
+    case CompareOp::EQ:
+      apply(begin, end, out, std::equal_to<VALUE>());
+      break;
+    case CompareOp::NE:
+      apply(begin, end, out, std::not_equal_to<VALUE>());
+      break;
+    case CompareOp::LT:
+      apply(begin, end, out, std::less<VALUE>());
+      break;
+    case CompareOp::LE:
+      apply(begin, end, out, std::less_equal<VALUE>());
+      break;
+    case CompareOp::GT:
+      apply(begin, end, out, std::greater<VALUE>());
+      break;
+    case CompareOp::GE:
+      apply(begin, end, out, std::greater_equal<VALUE>());
+      break;
+    }
+  }
+
+private:
+
+  template<typename OP>
+  void
+  apply(
+    long const begin,
+    long const end,
+    uint8_t* const out,
+    OP const op)
+    const
+  {
+    VALUE const value = value_;
+    long const num = end - begin;
+    if (stride_ == sizeof(TYPE)) {
+      TYPE const* const values
+        = reinterpret_cast<TYPE const*>(values_) + begin;
+      for (long i = 0; i < num; ++i)
+        out[i] = op((VALUE) values[i], value);
+    }
+    else
+      for (long i = 0; i < num; ++i)
+        out[i] = op(
+          (VALUE) load_strided<TYPE>(values_, stride_, begin + i), value);
+  }
+
+  char const* const values_;
+  CompareOp const op_;
+  VALUE const value_;
+  long const stride_;
+
+};
+
+
+/*
+ * Matches an array's values, each `stride` bytes apart, between `lo` and
+ * `hi`, inclusive.
+ */
+template<typename TYPE, typename VALUE>
+class RangePredicate
+  : public Predicate
+{
+public:
+
+  RangePredicate(
+    TYPE const* const values,
+    VALUE const lo,
+    VALUE const hi,
+    long const stride=sizeof(TYPE))
+  : values_(reinterpret_cast<char const*>(values)),
+    lo_(lo),
+    hi_(hi),
+    stride_(stride)
+  {
+  }
+
+  virtual ~RangePredicate() override {}
+
+  virtual void
+  evaluate(
+    long const begin,
+    long const end,
+    uint8_t* const out)
+    const override
+  {
+    VALUE const lo = lo_;
+    VALUE const hi = hi_;
+    for (long i = begin; i < end; ++i) {
+      auto const val = (VALUE) load_strided<TYPE>(values_, stride_, i);
+      out[i - begin] = lo <= val && val <= hi;
+    }
+  }
+
+private:
+
+  char const* const values_;
+  VALUE const lo_;
+  VALUE const hi_;
+  long const stride_;
+
+};
+
+
+/*
+ * Matches NaNs of a floating point array, whose values are `stride` bytes
+ * apart.
+ */
+template<typename TYPE>
+class NanPredicate
+  : public Predicate
+{
+public:
+
+  NanPredicate(
+    TYPE const* const values,
+    long const stride=sizeof(TYPE))
+  : values_(reinterpret_cast<char const*>(values)),
+    stride_(stride)
+  {
+  }
+
+  virtual ~NanPredicate() override {}
+
+  virtual void
+  evaluate(
+    long const begin,
+    long const end,
+    uint8_t* const out)
+    const override
+  {
+    for (long i = begin; i < end; ++i) {
+      TYPE const val = load_strided<TYPE>(values_, stride_, i);
+      out[i - begin] = val != val;
+    }
+  }
+
+private:
+
+  char const* const values_;
+  long const stride_;
+
+};
+
+
+/*
+ * Matches rows by a mask: nonzero bytes, or set bits of a bitmap, numbered
+ * from the least significant bit of each byte, starting at bit `offset`, as
+ * for Arrow validity bitmaps.
+ */
+class MaskPredicate
+  : public Predicate
+{
+public:
+
+  enum Kind { BYTES, BITS };
+
+  MaskPredicate(
+    uint8_t const* const mask,
+    Kind const kind=BYTES,
+    long const offset=0)
+  : mask_(mask),
+    kind_(kind),
+    offset_(offset)
+  {
+  }
+
+  virtual ~MaskPredicate() override {}
+
+  virtual void
+  evaluate(
+    long const begin,
+    long const end,
+    uint8_t* const out)
+    const override
+  {
+    if (kind_ == BYTES)
+      for (long i = begin; i < end; ++i)
+        out[i - begin] = mask_[offset_ + i] != 0;
+    else
+      for (long i = begin; i < end; ++i) {
+        long const bit = offset_ + i;
+        out[i - begin] = (mask_[bit / 8] >> (bit % 8)) & 1;
+      }
+  }
+
+private:
+
+  uint8_t const* const mask_;
+  Kind const kind_;
+  long const offset_;
+
+};
+
+
+/*
+ * String operations.
+ */
+enum class StringOp
+{
+  EQ, STARTSWITH, ENDSWITH, CONTAINS,
+};
+
+
+/*
+ * Matches strings, each the bytes of `data` from `offsets[e]` to
+ * `offsets[e + 1]` for entry `e`, against `pattern`.
+ *
+ * If `codes` is null, row `i` is entry `i`.  Otherwise, row `i` is entry
+ * `codes[i]` of `num_entries`, as for interned strings, and each entry is
+ * matched only once, up front.
+ */
+template<typename OFFSET, typename CODE=unsigned>
+class StringPredicate
+  : public Predicate
+{
+public:
+
+  StringPredicate(
+    OFFSET const* const offsets,
+    char const* const data,
+    StringOp const op,
+    string pattern,
+    CODE const* const codes=nullptr,
+    long const num_entries=0)
+  : offsets_(offsets),
+    data_(data),
+    op_(op),
+    pattern_(std::move(pattern)),
+    codes_(codes)
+  {
+    if (codes_ != nullptr) {
+      matches_.resize(num_entries);
+      for (long e = 0; e < num_entries; ++e)
+        matches_[e] = match(e);
+    }
+  }
+
+  virtual ~StringPredicate() override {}
+
+  virtual void
+  evaluate(
+    long const begin,
+    long const end,
+    uint8_t* const out)
+    const override
+  {
+    if (codes_ == nullptr)
+      for (long i = begin; i < end; ++i)
+        out[i - begin] = match(i);
+    else
+      for (long i = begin; i < end; ++i)
+        out[i - begin] = matches_[codes_[i]];
+  }
+
+private:
+
+  bool
+  match(
+    long const entry)
+    const
+  {
+    char const* const str = data_ + offsets_[entry];
+    size_t const size = offsets_[entry + 1] - offsets_[entry];
+    size_t const len = pattern_.size();
+    switch (op_) {
+    case StringOp::EQ:
+      return size == len && memcmp(str, pattern_.data(), len) == 0;
+    case StringOp::STARTSWITH:
+      return size >= len && memcmp(str, pattern_.data(), len) == 0;
+    case StringOp::ENDSWITH:
+      return
+        size >= len && memcmp(str + size - len, pattern_.data(), len) == 0;
+    case StringOp::CONTAINS:
+      return
+           len == 0
+        || std::search(str, str + size, pattern_.begin(), pattern_.end())
+           != str + size;
+    }
+    return false;
+  }
+
+  OFFSET const* const offsets_;
+  char const* const data_;
+  StringOp const op_;
+  string const pattern_;
+  CODE const* const codes_;
+  // If interned, whether each entry matches.
+  std::vector<uint8_t> matches_;
+
+};
+
+
+/*
+ * Combines predicates: rows that match all of them, or any of them.
+ */
+class AllAnyPredicate
+  : public Predicate
+{
+public:
+
+  AllAnyPredicate(
+    bool const all,
+    std::vector<unique_ptr<Predicate>> preds)
+  : all_(all),
+    preds_(std::move(preds))
+  {
+  }
+
+  virtual ~AllAnyPredicate() override {}
+
+  virtual void
+  evaluate(
+    long const begin,
+    long const end,
+    uint8_t* const out)
+    const override
+  {
+    std::fill(out, out + (end - begin), all_ ? 1 : 0);
+    std::vector<uint8_t> buf(end - begin);
+    for (auto const& pred : preds_) {
+      pred->evaluate(begin, end, buf.data());
+      if (all_)
+        for (long i = 0; i < end - begin; ++i)
+          out[i] &= buf[i];
+      else
+        for (long i = 0; i < end - begin; ++i)
+          out[i] |= buf[i];
+    }
+  }
+
+private:
+
+  bool const all_;
+  std::vector<unique_ptr<Predicate>> const preds_;
+
+};
+
+
+/*
+ * Negates a predicate.
+ */
+class NotPredicate
+  : public Predicate
+{
+public:
+
+  NotPredicate(
+    unique_ptr<Predicate> pred)
+  : pred_(std::move(pred))
+  {
+  }
+
+  virtual ~NotPredicate() override {}
+
+  virtual void
+  evaluate(
+    long const begin,
+    long const end,
+    uint8_t* const out)
+    const override
+  {
+    pred_->evaluate(begin, end, out);
+    for (long i = 0; i < end - begin; ++i)
+      out[i] ^= 1;
+  }
+
+private:
+
+  unique_ptr<Predicate> const pred_;
+
+};
+
+
+/*
+ * Number of rows `filter_rows()` evaluates at a time.
+ */
+constexpr long FILTER_BLOCK_SIZE = 16384;
+
+/*
+ * Appends to `rows` the indices of rows `begin` through `end` that match
+ * `pred`, evaluating a block of `block_size` rows at a time.
+ */
+inline void
+filter_rows(
+  Predicate const& pred,
+  long const begin,
+  long const end,
+  std::vector<long>& rows,
+  long const block_size=FILTER_BLOCK_SIZE)
+{
+  assert(begin <= end);
+  assert(block_size > 0);
+  std::vector<uint8_t> buf(std::min(end - begin, block_size));
+  for (long block = begin; block < end; block += block_size) {
+    long const block_end = std::min(block + block_size, end);
+    pred.evaluate(block, block_end, buf.data());
+    for (long i = block; i < block_end; ++i)
+      if (buf[i - block])
+        rows.push_back(i);
+  }
+}
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
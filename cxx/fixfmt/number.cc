@@ -31,21 +31,37 @@ Number::Scale const Number::SCALE_KIBI          = {1 << 10, "Ki"};
 
 //------------------------------------------------------------------------------
 
-string 
-Number::operator()(
-  long val) 
+namespace {
+
+inline char*
+copy(
+  string const& str,
+  char* const out)
+{
+  memcpy(out, str.data(), str.size());
+  return out + str.size();
+}
+
+
+}  // anonymous namespace
+
+
+char*
+Number::format(
+  long val,
+  char* const out)
   const
 {
   // Always use the FP code path if there's a scale.
   if (args_.scale.enabled())
-    return (*this)((double) val);
+    return format((double) val, out);
 
   if (val < 0 && args_.sign == SIGN_NONE)
-    return bad_;
+    return copy(bad_, out);
 
-  // Format directly into the string's buffer.
-  string result(alloc_size_, args_.pad);
-  char* const buf = &result[0];
+  // Without a scale, the width is the allocation size.
+  char* const buf = out;
+  memset(buf, args_.pad, width_);
 
   int const sign_len = args_.sign == SIGN_NONE ? 0 : 1;
   bool const nonneg = val >= 0;
@@ -61,7 +77,7 @@ Number::operator()(
       buf[sign_len + --i] = '0' + val % 10;
     // We should have rendered the entire value; otherwise we've overflowed.
     if (val != 0)
-      return bad_;
+      return copy(bad_, out);
   }
 
   // Render the sign.
@@ -77,28 +93,29 @@ Number::operator()(
       memset(point, '0', args_.precision);
   }
 
-  assert(string_length(result) == width_);
-  return result;
+  assert(string_length(string(buf, width_)) == width_);
+  return buf + width_;
 }
 
 
-string 
-Number::operator()(
-  double const value) 
+char*
+Number::format(
+  double const value,
+  char* out)
   const
 {
   if (std::isnan(value))
-    return nan_;
+    return copy(nan_, out);
   else if (value < 0 && args_.sign == SIGN_NONE)
     // With SIGN_NONE, we can't render negative numbers.
-    return bad_;
+    return copy(bad_, out);
 
   // Apply the scale factor, if any.
   double const val = args_.scale.enabled() ? value / args_.scale.factor : value;
 
   if (std::isinf(val))
     // Return the appropriate infinity.
-    return val >= 0 ? pos_inf_ : neg_inf_;
+    return copy(val >= 0 ? pos_inf_ : neg_inf_, out);
 
   else {
     int const precision 
@@ -120,11 +137,11 @@ Number::operator()(
     // assert(length - decimal_pos == precision);
     assert(length - decimal_pos <= precision);
 
-    string result;
-
     if (decimal_pos > args_.size)
       // Integral part too large.
-      return bad_;
+      return copy(bad_, out);
+
+    char* const start = out;
 
     // The number of digits in the integral part.
     //
@@ -137,50 +154,64 @@ Number::operator()(
 
     // Add pad and sign.  Space padding precedes sign, while zero padding
     // follows it.  
-    if (args_.pad == PAD_SPACE && args_.size > int_digits)
+    if (args_.pad == PAD_SPACE && args_.size > int_digits) {
       // Space padding. 
-      result.append(args_.size - int_digits, ' ');
+      memset(out, ' ', args_.size - int_digits);
+      out += args_.size - int_digits;
+    }
     if (args_.sign != SIGN_NONE)
       // The sign character.
-      result.push_back(get_sign_char(val >= 0));
-    if (args_.pad == PAD_ZERO && args_.size > int_digits)
+      *out++ = get_sign_char(val >= 0);
+    if (args_.pad == PAD_ZERO && args_.size > int_digits) {
       // Zero padding.
-      result.append(args_.size - int_digits, '0');
+      memset(out, '0', args_.size - int_digits);
+      out += args_.size - int_digits;
+    }
 
     // Add digits for the integral part.
     if (decimal_pos > length) {
       // The integral part needs to be zero-padded.
-      result.append(buf, length);
-      result.append(decimal_pos - length, '0');
+      memcpy(out, buf, length);
+      memset(out + length, '0', decimal_pos - length);
+      out += decimal_pos;
       length = decimal_pos;
     }
-    else if (decimal_pos > 0)
-      result.append(buf, decimal_pos);
+    else if (decimal_pos > 0) {
+      memcpy(out, buf, decimal_pos);
+      out += decimal_pos;
+    }
     else if (args_.size > 0)
       // Show at least one zero.
-      result.push_back('0');
+      *out++ = '0';
 
     if (args_.precision != PRECISION_NONE) {
       // Add the decimal point.
-      result.push_back(args_.point);
+      *out++ = args_.point;
       
       // Pad with zeros after the decimal point if needed.
-      if (decimal_pos < 0)
-        result.append(-decimal_pos, '0');
+      if (decimal_pos < 0) {
+        memset(out, '0', -decimal_pos);
+        out += -decimal_pos;
+      }
       // Add fractional digits.
-      if (length - decimal_pos > 0)
-        result.append(&buf[std::max(decimal_pos, 0)]);
+      int const frac_start = std::max(decimal_pos, 0);
+      if (length - decimal_pos > 0) {
+        memcpy(out, buf + frac_start, length - frac_start);
+        out += length - frac_start;
+      }
       // Pad with zeros at the end, if necessary.
-      if (length - decimal_pos < args_.precision)
-        result.append(args_.precision - (length - decimal_pos), '0');
+      if (length - decimal_pos < args_.precision) {
+        memset(out, '0', args_.precision - (length - decimal_pos));
+        out += args_.precision - (length - decimal_pos);
+      }
     }
  
     if (args_.scale.enabled()) 
       // Tack on the scale suffix.
-      result.append(args_.scale.suffix);
+      out = copy(args_.scale.suffix, out);
 
-    assert(string_length(result) == width_);
-    return result;
+    assert(string_length(string(start, out - start)) == width_);
+    return out;
   }
 }
 
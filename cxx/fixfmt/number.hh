@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include "fixfmt/base.hh"
 #include "fixfmt/math.hh"
@@ -118,17 +120,61 @@ public:
     { check(args); args_ = std::move(args); set_up(); }
 
   size_t        get_width() const noexcept { return width_; }
-  string        operator()(long val) const;
-  string        operator()(double val) const;
-
-  // Make sure we use the integer implementation for integral types.
-  string operator()(int            val) const { return operator()((long) val); }
-  string operator()(short          val) const { return operator()((long) val); }
-  string operator()(char           val) const { return operator()((long) val); }
-  string operator()(unsigned long  val) const { return operator()((long) val); }
-  string operator()(unsigned int   val) const { return operator()((long) val); }
-  string operator()(unsigned short val) const { return operator()((long) val); }
-  string operator()(unsigned char  val) const { return operator()((long) val); }
+
+  /*
+   * Returns the most bytes a formatted value may take.
+   */
+  size_t        get_max_bytes() const noexcept { return max_bytes_; }
+
+  /*
+   * Formats `val` into `out`, which must have room for `get_max_bytes()`
+   * bytes.  Returns the end of the output.
+   */
+  char*         format(long val, char* out) const;
+  char*         format(double val, char* out) const;
+
+  /*
+   * Formats other arithmetic types with the integer implementation, for
+   * integral types, or else the floating point one.
+   */
+  template<typename TYPE>
+  char*
+  format(
+    TYPE const val,
+    char* const out)
+    const
+  {
+    return std::is_integral<TYPE>::value
+      ? format((long) val, out)
+      : format((double) val, out);
+  }
+
+  /*
+   * Formats `num` values; value `i` is written at `pos[i]`, which is
+   * advanced past it.
+   */
+  template<typename TYPE>
+  void
+  format(
+    TYPE const* const vals,
+    long const num,
+    char** const pos)
+    const
+  {
+    for (long i = 0; i < num; ++i)
+      pos[i] = format(vals[i], pos[i]);
+  }
+
+  template<typename TYPE>
+  string
+  operator()(
+    TYPE const val)
+    const
+  {
+    string result(max_bytes_, ' ');
+    result.resize(format(val, &result[0]) - &result[0]);
+    return result;
+  }
 
 private:
 
@@ -143,6 +189,8 @@ private:
   size_t    width_;
   // Maximum allocation size.
   size_t    alloc_size_;
+  // Maximum output size, including special values.
+  size_t    max_bytes_;
 
   string    nan_;
   string    pos_inf_;
@@ -222,6 +270,8 @@ Number::set_up()
   pos_inf_ = format_inf_nan(args_.inf,  1);
   neg_inf_ = format_inf_nan(args_.inf, -1);
   bad_ = std::string(width_, args_.bad);
+  max_bytes_ = std::max({
+    alloc_size_, nan_.size(), pos_inf_.size(), neg_inf_.size(), bad_.size()});
 }
 
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "fixfmt/base.hh"
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+using std::unique_ptr;
+
+/*
+ * A key by which to order rows.
+ */
+class SortKey
+{
+public:
+
+  virtual ~SortKey() = default;
+
+  /*
+   * Returns negative, zero, or positive, as row `i` sorts before, with, or
+   * after row `j`.
+   */
+  virtual int compare(long i, long j) const = 0;
+
+};
+
+
+/*
+ * A key of an array's values, each `stride` bytes apart.
+ *
+ * NaNs sort after all other values, whether ascending or descending.
+ */
+template<typename TYPE>
+class ArraySortKey
+  : public SortKey
+{
+public:
+
+  ArraySortKey(
+    TYPE const* const values,
+    bool const descending=false,
+    long const stride=sizeof(TYPE))
+  : values_(reinterpret_cast<char const*>(values)),
+    descending_(descending),
+    stride_(stride)
+  {
+  }
+
+  virtual ~ArraySortKey() override {}
+
+  virtual int
+  compare(
+    long const i,
+    long const j)
+    const override
+  {
+    TYPE const a = get(i);
+    TYPE const b = get(j);
+    // Only NaNs are unequal to themselves.
+    bool const a_nan = a != a;
+    bool const b_nan = b != b;
+    if (a_nan || b_nan)
+      return a_nan - b_nan;
+    int const cmp = a < b ? -1 : b < a ? 1 : 0;
+    return descending_ ? -cmp : cmp;
+  }
+
+private:
+
+  TYPE
+  get(
+    long const index)
+    const
+  {
+    return load_strided<TYPE>(values_, stride_, index);
+  }
+
+  char const* const values_;
+  bool const descending_;
+  long const stride_;
+
+};
+
+
+/*
+ * Orders the `length` rows by `keys`, the first key first, and stores the
+ * first `num` row indices in that order in `rows`.
+ *
+ * Ties are broken by row index, so the order is stable.  If `num` is less
+ * than `length`, only the leading `num` rows are sorted, as for the top N
+ * rows, in O(length log num) time.
+ */
+inline void
+argsort(
+  std::vector<unique_ptr<SortKey>> const& keys,
+  long const length,
+  long* const rows,
+  long const num)
+{
+  assert(0 <= num && num <= length);
+  std::vector<long> order(length);
+  std::iota(order.begin(), order.end(), 0);
+
+  auto const before = [&keys](long const i, long const j) {
+    for (auto const& key : keys) {
+      int const cmp = key->compare(i, j);
+      if (cmp != 0)
+        return cmp < 0;
+    }
+    return i < j;
+  };
+
+  if (num < length)
+    std::partial_sort(order.begin(), order.begin() + num, order.end(), before);
+  else
+    std::sort(order.begin(), order.end(), before);
+  std::copy(order.begin(), order.begin() + num, rows);
+}
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
@@ -48,6 +48,21 @@ public:
   size_t        get_width() const noexcept { return args_.size; }
   string        operator()(string const& str) const;
 
+  /*
+   * Returns the most bytes a string of `size` bytes may take, formatted.
+   * Escape sequences have no width, so this depends on the size, not only
+   * on the width.
+   */
+  size_t
+  get_max_bytes(
+    size_t const size)
+    const noexcept
+  {
+    // Eliding removes at least as many bytes as the ellipsis replaces;
+    // padding adds at most a copy of the pad per character.
+    return size + args_.ellipsis.size() + args_.size * args_.pad.size();
+  }
+
 private:
 
   static void   check(Args const&);
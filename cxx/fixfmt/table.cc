@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "table.hh"
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+constexpr int Column::NO_MAX_BYTES;
+
+void
+Table::render_parallel(
+  long const begin,
+  long const end,
+  Sink& sink,
+  int num_threads,
+  long const block_size,
+  int max_blocks)
+  const
+{
+  assert(0 <= begin && begin <= end && end <= get_length());
+  assert(block_size > 0);
+  assert(num_threads >= 0);
+  assert(max_blocks >= 0);
+
+  long const num_blocks = (end - begin + block_size - 1) / block_size;
+  if (num_threads == 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  num_threads = (int) std::min((long) num_threads, num_blocks);
+  if (num_threads <= 1 || !is_thread_safe() || max_bytes_ == NO_MAX_BYTES) {
+    render(begin, end, sink);
+    return;
+  }
+  if (max_blocks == 0)
+    max_blocks = 2 * num_threads;
+  max_blocks = std::max(max_blocks, num_threads);
+
+  // Block 'b' is formatted into slot 'b % max_blocks', whose 'done' is
+  // the number of the last block formatted into it.
+  struct Slot
+  {
+    std::vector<char> buf;
+    std::vector<char*> pos;
+    long done = -1;
+  };
+  std::vector<Slot> slots(max_blocks);
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  // The next block to claim, and to emit.
+  long next_block = 0;
+  long next_emit = 0;
+  bool stop = false;
+  std::exception_ptr error;
+
+  auto const work = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      // Wait for a free slot.
+      cond.wait(lock, [&] {
+        return stop || next_block >= num_blocks
+          || next_block < next_emit + max_blocks;
+      });
+      if (stop || next_block >= num_blocks)
+        return;
+      long const block = next_block++;
+      Slot& slot = slots[block % max_blocks];
+
+      lock.unlock();
+      long const block_begin = begin + block * block_size;
+      long const block_end = std::min(block_begin + block_size, end);
+      try {
+        slot.buf.resize((block_end - block_begin) * max_bytes_);
+        slot.pos.resize(block_end - block_begin);
+        format_rows(block_begin, block_end, slot.buf.data(), slot.pos.data());
+      }
+      catch (...) {
+        lock.lock();
+        if (!error)
+          error = std::current_exception();
+        stop = true;
+        cond.notify_all();
+        return;
+      }
+      lock.lock();
+
+      slot.done = block;
+      cond.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i)
+    threads.emplace_back(work);
+
+  // Emit blocks in order, on this thread.
+  try {
+    for (long block = 0; block < num_blocks; ++block) {
+      Slot& slot = slots[block % max_blocks];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return stop || slot.done == block; });
+        if (stop)
+          break;
+      }
+
+      long const block_begin = begin + block * block_size;
+      long const block_end = std::min(block_begin + block_size, end);
+      emit_rows(block_begin, block_end, slot.buf.data(), slot.pos.data(), sink);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      ++next_emit;
+      cond.notify_all();
+    }
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error)
+      error = std::current_exception();
+    stop = true;
+    cond.notify_all();
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
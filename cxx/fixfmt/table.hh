@@ -1,14 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <numeric>
-#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "fixfmt/base.hh"
+#include "fixfmt/bool.hh"
+#include "fixfmt/text.hh"
+
 //------------------------------------------------------------------------------
 
 namespace fixfmt {
@@ -34,24 +41,175 @@ public:
    */
   virtual long get_length() const = 0;
 
+  /**
+   * Returns true if entries may be formatted concurrently from several
+   * threads.  Formatters are const, so this is so unless a column calls
+   * into something that isn't, such as the Python interpreter.
+   */
+  virtual bool is_thread_safe() const { return true; }
+
+  /**
+   * Returned by `get_max_bytes()` if there is no bound.
+   */
+  constexpr static int NO_MAX_BYTES = -1;
+
+  /**
+   * Returns the most bytes a formatted entry may take, or `NO_MAX_BYTES` if
+   * this isn't known in advance.  Entries are UTF-8, so by default, this
+   * allows four bytes per character; columns whose entries may contain
+   * escape sequences, which have no width, must override this.
+   */
+  virtual int get_max_bytes() const { return 4 * get_width(); }
+
   /**
    * Formats entry 'index'.
    */
   virtual string operator()(long index) const = 0;
 
+  /**
+   * Formats entry 'index' into 'out', which must have room for
+   * 'get_max_bytes()' bytes.  Returns the end of the output.
+   */
+  virtual char*
+  format_into(
+    long const index,
+    char* const out)
+    const
+  {
+    string const str = (*this)(index);
+    memcpy(out, str.data(), str.size());
+    return out + str.size();
+  }
+
+  /**
+   * Formats entries 'begin' through 'end', appending entry 'begin + i' at
+   * 'pos[i]' and advancing it.
+   */
+  virtual void
+  format(
+    long const begin,
+    long const end,
+    char** pos)
+    const
+  {
+    for (long i = begin; i < end; ++i, ++pos)
+      *pos = format_into(i, *pos);
+  }
+
 };
 
 
+/**
+ * Formats `val` into `out` with `fmt`, directly if the formatter provides
+ * `char* format(val, out)`, else by way of a string.
+ */
+template<typename FMT, typename TYPE>
+inline auto
+format_into(
+  FMT const& fmt,
+  TYPE const val,
+  char* const out,
+  int /* prefer */)
+  -> decltype(fmt.format(val, out))
+{
+  return fmt.format(val, out);
+}
+
+
+template<typename FMT, typename TYPE>
+inline char*
+format_into(
+  FMT const& fmt,
+  TYPE const val,
+  char* const out,
+  long /* fallback */)
+{
+  // Binds either a returned string or a reference to one held by `fmt`.
+  auto const& str = fmt(val);
+  memcpy(out, str.data(), str.size());
+  return out + str.size();
+}
+
+
+/**
+ * Returns the most bytes `fmt` may produce: its own bound if it provides
+ * `get_max_bytes()`, else four UTF-8 bytes per character.
+ */
+template<typename FMT>
+inline auto
+get_max_bytes(
+  FMT const& fmt,
+  int /* prefer */)
+  -> decltype((int) fmt.get_max_bytes())
+{
+  return fmt.get_max_bytes();
+}
+
+
+template<typename FMT>
+inline int
+get_max_bytes(
+  FMT const& fmt,
+  long /* fallback */)
+{
+  return 4 * fmt.get_width();
+}
+
+
+/**
+ * Formats `num` values with `fmt`, appending value `i` at `pos[i]` and
+ * advancing it.  Uses the formatter's own batch `format(vals, num, pos)` if
+ * it has one.
+ */
+template<typename FMT, typename TYPE>
+inline auto
+format_block(
+  FMT const& fmt,
+  TYPE const* const vals,
+  long const num,
+  char** const pos,
+  int /* prefer */)
+  -> decltype(fmt.format(vals, num, pos))
+{
+  return fmt.format(vals, num, pos);
+}
+
+
+template<typename FMT, typename TYPE>
+inline void
+format_block(
+  FMT const& fmt,
+  TYPE const* const vals,
+  long const num,
+  char** const pos,
+  long /* fallback */)
+{
+  for (long i = 0; i < num; ++i)
+    pos[i] = format_into(fmt, vals[i], pos[i], 0);
+}
+
+
+/**
+ * A column of values formatted with `FMT`.
+ *
+ * Values are `stride` bytes apart, which may be other than `sizeof(TYPE)`,
+ * as for a column of a 2-D array or a field of a record array.
+ */
 template<typename TYPE, typename FMT>
 class ColumnImpl
   : public Column
 {
 public:
 
-  ColumnImpl(TYPE const* values, long length, FMT format)
+  ColumnImpl(
+    TYPE const* values, 
+    long length, 
+    FMT format, 
+    long const stride=sizeof(TYPE))
   : values_(values),
     length_(length),
-    format_(std::move(format))
+    format_(std::move(format)),
+    stride_(stride)
   {
   }
 
@@ -61,18 +219,166 @@ public:
 
   virtual long get_length() const override { return length_; }
 
+  virtual int 
+  get_max_bytes() 
+    const override 
+  { 
+    return fixfmt::get_max_bytes(format_, 0); 
+  }
+
   virtual string operator()(long const index) const override
   {
-    return format_(values_[index]);
+    return format_(get(index));
+  }
+
+  virtual char* 
+  format_into(
+    long const index, 
+    char* const out) 
+    const override
+  {
+    return fixfmt::format_into(format_, get(index), out, 0);
+  }
+
+  virtual void
+  format(
+    long const begin,
+    long const end,
+    char** const pos)
+    const override
+  {
+    if (stride_ == (long) sizeof(TYPE))
+      format_block(format_, values_ + begin, end - begin, pos, 0);
+    else {
+      // Gather strided values into a contiguous chunk for the formatter.
+      TYPE vals[GATHER_SIZE];
+      for (long i = begin; i < end; i += GATHER_SIZE) {
+        long const num = end - i < GATHER_SIZE ? end - i : GATHER_SIZE;
+        for (long j = 0; j < num; ++j)
+          vals[j] = load_strided<TYPE>(values_, stride_, i + j);
+        format_block(format_, vals, num, pos + (i - begin), 0);
+      }
+    }
   }
 
   FMT const& get_format() const { return format_; }
 
 private:
 
+  constexpr static long GATHER_SIZE = 256;
+
+  TYPE 
+  get(
+    long const index) 
+    const
+  {
+    return 
+        stride_ == (long) sizeof(TYPE) ? values_[index]
+      : load_strided<TYPE>(values_, stride_, index);
+  }
+
   TYPE const* const values_;
   long const length_;
   FMT const format_;
+  long const stride_;
+
+};
+
+
+/**
+ * A column of integral codes into a dictionary of pre-formatted categories.
+ *
+ * Each category is formatted exactly once, when the column is constructed;
+ * formatting an entry is then a lookup by code.  Negative or out-of-range
+ * codes, such as the -1 pandas uses for missing values, format as `missing`.
+ */
+template<typename IDXTYPE>
+class CategoricalColumn
+  : public Column
+{
+public:
+
+  CategoricalColumn(
+    IDXTYPE const* const codes,
+    long const length,
+    Column const& categories,
+    string const& missing="",
+    long const stride=sizeof(IDXTYPE))
+  : codes_(codes),
+    length_(length),
+    stride_(stride),
+    width_(categories.get_width()),
+    missing_(palide(missing, width_, "", " ", 1, PAD_POS_LEFT_JUSTIFY))
+  {
+    long const num_categories = categories.get_length();
+    assert(num_categories < MAX_INDEX);
+    categories_.reserve(num_categories);
+    for (long i = 0; i < num_categories; ++i) {
+      categories_.push_back(categories(i));
+      max_bytes_ = std::max(max_bytes_, (int) categories_.back().size());
+    }
+  }
+
+  virtual ~CategoricalColumn() override {}
+
+  virtual int get_width() const override { return width_; }
+
+  virtual long get_length() const override { return length_; }
+
+  virtual int get_max_bytes() const override { return max_bytes_; }
+
+  virtual string operator()(long const index) const override
+  {
+    return get(index);
+  }
+
+  virtual char* 
+  format_into(
+    long const index, 
+    char* const out) 
+    const override
+  {
+    string const& str = get(index);
+    memcpy(out, str.data(), str.size());
+    return out + str.size();
+  }
+
+  virtual void
+  format(
+    long const begin,
+    long const end,
+    char** pos)
+    const override
+  {
+    for (long i = begin; i < end; ++i, ++pos) {
+      string const& str = get(i);
+      memcpy(*pos, str.data(), str.size());
+      *pos += str.size();
+    }
+  }
+
+  long get_num_categories() const { return categories_.size(); }
+
+private:
+
+  string const&
+  get(
+    long const index)
+    const
+  {
+    long const code = (long) load_strided<IDXTYPE>(codes_, stride_, index);
+    return 
+        0 <= code && code < (long) categories_.size() ? categories_[code]
+      : missing_;
+  }
+
+  IDXTYPE const* const codes_;
+  long const length_;
+  long const stride_;
+  int const width_;
+  string const missing_;
+  std::vector<string> categories_;
+  int max_bytes_ = missing_.size();
 
 };
 
@@ -80,43 +386,390 @@ private:
 /**
  * A column with one degree of indirection through an integral index column.
  *
- * For categorical columns.
+ * For categorical columns.  The values of `column` are formatted once, up
+ * front; see `CategoricalColumn`.
  */
 template<typename IDXTYPE, typename TYPE, typename FMT>
 class IndexedColumn
-  : public Column
+  : public CategoricalColumn<IDXTYPE>
 {
 public:
 
   IndexedColumn(
     IDXTYPE const* const index, 
     long const index_length, 
-    ColumnImpl<TYPE, FMT> column)
-    : index_(index),
-      index_length_(index_length),
-      column_(std::move(column))
+    ColumnImpl<TYPE, FMT> const& column)
+    : CategoricalColumn<IDXTYPE>(index, index_length, column)
   {
   }
 
   virtual ~IndexedColumn() override {}
 
-  virtual int get_width() const override 
-  { 
-    return column_.get_format().get_width(); 
+};
+
+
+/**
+ * A column of bit-packed booleans.
+ *
+ * Entry `index` is bit `offset + index` of `bits`.  If `lsb_first`, the
+ * default, bits are numbered from the least significant bit of each byte, as
+ * in Arrow buffers; otherwise from the most significant bit, as by
+ * `np.packbits()` by default.
+ */
+class BitBoolColumn
+  : public Column
+{
+public:
+
+  BitBoolColumn(
+    uint8_t const* const bits,
+    long const offset,
+    long const length,
+    Bool format,
+    bool const lsb_first=true)
+  : bits_(bits),
+    offset_(offset),
+    length_(length),
+    format_(std::move(format)),
+    lsb_first_(lsb_first)
+  {
   }
 
-  virtual long get_length() const override { return index_length_; }
+  virtual ~BitBoolColumn() override {}
+
+  virtual int get_width() const override { return format_.get_width(); }
+
+  virtual long get_length() const override { return length_; }
+
+  virtual int get_max_bytes() const override
+    { return format_.get_max_bytes(); }
 
   virtual string operator()(long const index) const override
   {
-    return column_(index_[index]);
+    return format_(get(index));
+  }
+
+  virtual char* 
+  format_into(
+    long const index, 
+    char* const out) 
+    const override
+  {
+    string const& str = format_(get(index));
+    memcpy(out, str.data(), str.size());
+    return out + str.size();
+  }
+
+  bool 
+  get(
+    long const index) 
+    const
+  {
+    long const bit = offset_ + index;
+    return (bits_[bit / 8] >> (lsb_first_ ? bit % 8 : 7 - bit % 8)) & 1;
+  }
+
+  virtual void format(long begin, long end, char** pos) const override;
+
+  Bool const& get_format() const { return format_; }
+
+private:
+
+  uint8_t const* const bits_;
+  long const offset_;
+  long const length_;
+  Bool const format_;
+  bool const lsb_first_;
+
+};
+
+
+inline void
+BitBoolColumn::format(
+  long const begin,
+  long const end,
+  char** pos)
+  const
+{
+  string const& true_str = format_.get_true();
+  string const& false_str = format_.get_false();
+  auto const put = [&](bool const val) {
+    string const& str = val ? true_str : false_str;
+    memcpy(*pos, str.data(), str.size());
+    *pos++ += str.size();
+  };
+
+  long i = begin;
+  // Single bits, up to a byte boundary.
+  for (; i < end && (offset_ + i) % 8 != 0; ++i)
+    put(get(i));
+
+  // 64 bits at a time.
+  for (; i + 64 <= end; i += 64) {
+    uint8_t const* const bytes = bits_ + (offset_ + i) / 8;
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    if (word == 0 || word == ~(uint64_t) 0) {
+      // All bits are the same; no need to extract them.
+      string const& str = word == 0 ? false_str : true_str;
+      for (int j = 0; j < 64; ++j) {
+        memcpy(*pos, str.data(), str.size());
+        *pos++ += str.size();
+      }
+    }
+    else
+      for (int k = 0; k < 8; ++k) {
+        uint8_t const byte = bytes[k];
+        if (lsb_first_)
+          for (int j = 0; j < 8; ++j)
+            put((byte >> j) & 1);
+        else
+          for (int j = 7; j >= 0; --j)
+            put((byte >> j) & 1);
+      }
+  }
+
+  // Remaining single bits.
+  for (; i < end; ++i)
+    put(get(i));
+}
+
+
+/**
+ * A column with null entries, which format as `null`, padded to the width.
+ *
+ * With `MASK_VALID_BITS`, entry `index` is valid if bit `offset + index` of
+ * `mask` is set, counting from the least significant bit of each byte, as in
+ * an Arrow validity bitmap.  With `MASK_NULL_BYTES`, entry `index` is null if
+ * byte `offset + index` of `mask` is nonzero, as in a numpy masked array or a
+ * pandas nullable array.
+ */
+class NullableColumn
+  : public Column
+{
+public:
+
+  constexpr static int MASK_VALID_BITS  = 0;
+  constexpr static int MASK_NULL_BYTES  = 1;
+
+  NullableColumn(
+    unique_ptr<Column> column,
+    uint8_t const* const mask,
+    int const mask_kind,
+    long const offset=0,
+    string const& null="",
+    float const pad_pos=PAD_POS_LEFT_JUSTIFY)
+  : column_(std::move(column)),
+    mask_(mask),
+    mask_kind_(mask_kind),
+    offset_(offset),
+    null_(palide(null, column_->get_width(), "", " ", 1, pad_pos))
+  {
+    assert(mask_kind_ == MASK_VALID_BITS || mask_kind_ == MASK_NULL_BYTES);
+  }
+
+  virtual ~NullableColumn() override {}
+
+  virtual int get_width() const override { return column_->get_width(); }
+
+  virtual long get_length() const override { return column_->get_length(); }
+
+  virtual bool 
+  is_thread_safe() 
+    const override 
+  { 
+    return column_->is_thread_safe(); 
+  }
+
+  virtual int
+  get_max_bytes()
+    const override
+  {
+    int const max_bytes = column_->get_max_bytes();
+    return
+        max_bytes == NO_MAX_BYTES ? NO_MAX_BYTES
+      : std::max(max_bytes, (int) null_.size());
+  }
+
+  bool
+  is_null(
+    long const index)
+    const
+  {
+    if (mask_kind_ == MASK_VALID_BITS) {
+      long const bit = offset_ + index;
+      return !((mask_[bit / 8] >> (bit % 8)) & 1);
+    }
+    else
+      return mask_[offset_ + index] != 0;
   }
 
+  virtual string 
+  operator()(
+    long const index) 
+    const override
+  {
+    return is_null(index) ? null_ : (*column_)(index);
+  }
+
+  virtual char* 
+  format_into(
+    long const index, 
+    char* const out) 
+    const override
+  {
+    if (is_null(index)) {
+      memcpy(out, null_.data(), null_.size());
+      return out + null_.size();
+    }
+    else
+      return column_->format_into(index, out);
+  }
+
+  /**
+   * Formats the block with the underlying column's kernel, then overwrites
+   * null entries, whose underlying values are formatted but unused.
+   */
+  virtual void
+  format(
+    long const begin,
+    long const end,
+    char** const pos)
+    const override
+  {
+    // Remember where each entry starts, a chunk at a time.
+    char* starts[CHUNK_SIZE];
+    for (long i = begin; i < end; i += CHUNK_SIZE) {
+      long const num = end - i < CHUNK_SIZE ? end - i : CHUNK_SIZE;
+      char** const chunk_pos = pos + (i - begin);
+      std::copy(chunk_pos, chunk_pos + num, starts);
+      column_->format(i, i + num, chunk_pos);
+      for (long j = 0; j < num; ++j)
+        if (is_null(i + j)) {
+          memcpy(starts[j], null_.data(), null_.size());
+          chunk_pos[j] = starts[j] + null_.size();
+        }
+    }
+  }
+
+  string const& get_null() const { return null_; }
+
 private:
 
-  IDXTYPE const* const index_;
-  long const index_length_;
-  ColumnImpl<TYPE, FMT> const column_;
+  constexpr static long CHUNK_SIZE = 256;
+
+  unique_ptr<Column> const column_;
+  uint8_t const* const mask_;
+  int const mask_kind_;
+  long const offset_;
+  string const null_;
+
+};
+
+
+/**
+ * A column made of consecutive chunks, such as the arrays of an Arrow
+ * chunked array, which needn't be concatenated.
+ *
+ * Chunks must have the same width.  An entry is found by binary search of
+ * the chunks' start offsets; block formatting runs each chunk's kernel on
+ * its part of the block.
+ */
+class ChunkedColumn
+  : public Column
+{
+public:
+
+  ChunkedColumn(
+    int const width)
+  : width_(width)
+  {
+  }
+
+  virtual ~ChunkedColumn() override {}
+
+  void
+  add_chunk(
+    unique_ptr<Column> chunk)
+  {
+    assert(chunk->get_width() == width_);
+    int const max_bytes = chunk->get_max_bytes();
+    max_bytes_ =
+        max_bytes_ == NO_MAX_BYTES || max_bytes == NO_MAX_BYTES ? NO_MAX_BYTES
+      : std::max(max_bytes_, max_bytes);
+    thread_safe_ = thread_safe_ && chunk->is_thread_safe();
+    starts_.push_back(get_length() + chunk->get_length());
+    chunks_.push_back(std::move(chunk));
+  }
+
+  long get_num_chunks() const { return chunks_.size(); }
+
+  virtual int get_width() const override { return width_; }
+
+  virtual long get_length() const override { return starts_.back(); }
+
+  virtual bool is_thread_safe() const override { return thread_safe_; }
+
+  virtual int get_max_bytes() const override { return max_bytes_; }
+
+  virtual string
+  operator()(
+    long const index)
+    const override
+  {
+    long const c = find_chunk(index);
+    return (*chunks_[c])(index - starts_[c]);
+  }
+
+  virtual char*
+  format_into(
+    long const index,
+    char* const out)
+    const override
+  {
+    long const c = find_chunk(index);
+    return chunks_[c]->format_into(index - starts_[c], out);
+  }
+
+  virtual void
+  format(
+    long const begin,
+    long const end,
+    char** const pos)
+    const override
+  {
+    if (begin == end)
+      return;
+    for (long c = find_chunk(begin), i = begin; i < end; ++c) {
+      long const chunk_end = std::min(end, starts_[c + 1]);
+      chunks_[c]->format(
+        i - starts_[c], chunk_end - starts_[c], pos + (i - begin));
+      i = chunk_end;
+    }
+  }
+
+private:
+
+  /*
+   * Returns the chunk containing entry `index`.
+   */
+  long
+  find_chunk(
+    long const index)
+    const
+  {
+    assert(0 <= index && index < get_length());
+    // The last start not after `index`.
+    return std::upper_bound(starts_.begin(), starts_.end(), index)
+      - starts_.begin() - 1;
+  }
+
+  int const width_;
+  std::vector<unique_ptr<Column>> chunks_;
+  // Start of each chunk, and then the total length.
+  std::vector<long> starts_ = {0};
+  int max_bytes_ = 0;
+  bool thread_safe_ = true;
 
 };
 
@@ -135,9 +788,36 @@ public:
 
   virtual long get_length() const override { return MAX_INDEX; }
 
+  virtual int get_max_bytes() const override { return str_.size(); }
+
   virtual string operator()(long const /* index */) const override
     { return str_; }
 
+  virtual char*
+  format_into(
+    long const /* index */,
+    char* const out)
+    const override
+  {
+    memcpy(out, str_.data(), str_.size());
+    return out + str_.size();
+  }
+
+  virtual void
+  format(
+    long const begin,
+    long const end,
+    char** pos)
+    const override
+  {
+    char const* const data = str_.data();
+    size_t const size = str_.size();
+    for (long i = begin; i < end; ++i, ++pos) {
+      memcpy(*pos, data, size);
+      *pos += size;
+    }
+  }
+
 private:
 
   string str_;
@@ -147,18 +827,57 @@ private:
 
 //------------------------------------------------------------------------------
 
+/**
+ * Receives rows rendered by `Table::render()`.
+ */
+class Sink
+{
+public:
+
+  virtual ~Sink() = default;
+
+  /**
+   * Receives row 'index', the 'size' bytes at 'row'.  The bytes are valid
+   * only during the call.
+   */
+  virtual void operator()(long index, char const* row, size_t size) = 0;
+
+  /**
+   * Receives the 'size' bytes at 'line', which stand in for rows elided by
+   * `Table::render_visible()`.
+   */
+  virtual void ellipsis(char const* /* line */, size_t /* size */) {}
+
+};
+
+
 class Table
   : public Column
 {
 public:
 
-  Table() : width_(0), length_(MAX_INDEX) {}
+  /**
+   * Number of rows `render()` formats at a time.
+   */
+  constexpr static long TILE_SIZE = 1024;
+
+  /**
+   * Default number of rows `render_parallel()` gives a thread at a time.
+   */
+  constexpr static long BLOCK_SIZE = 16384;
+
+  Table() : width_(0), max_bytes_(0), length_(MAX_INDEX) {}
 
   void 
   add_column(
     unique_ptr<Column> col)
   {
     width_ += col->get_width();
+    int const max_bytes = col->get_max_bytes();
+    max_bytes_ =
+        max_bytes_ == NO_MAX_BYTES || max_bytes == NO_MAX_BYTES ? NO_MAX_BYTES
+      : max_bytes_ + max_bytes;
+    assert(col->get_length() >= rows_end_);
     length_ = std::min(length_, col->get_length());
     columns_.push_back(std::move(col));
   }
@@ -170,26 +889,317 @@ public:
     add_column(unique_ptr<Column>(new StringColumn(std::move(str)))); 
   }
 
+  /**
+   * Selects the rows to show: row 'i' of the table is row 'rows[i]' of its
+   * columns, for 'i' less than 'num_rows'.  The selection may reorder rows,
+   * as a sort permutation does, or skip them, as a filter does.  Columns are
+   * read through it as rows are rendered, so are neither reordered nor
+   * copied.  'rows' is not copied either, so must outlive the table; null
+   * shows all rows again.  Columns added later must have the selected rows.
+   */
+  void
+  select(
+    long const* const rows,
+    long const num_rows)
+  {
+    assert(rows == nullptr || num_rows >= 0);
+    rows_ = rows;
+    num_rows_ = num_rows;
+    rows_end_ = 0;
+    if (rows != nullptr)
+      for (long i = 0; i < num_rows; ++i) {
+        assert(0 <= rows[i] && rows[i] < length_);
+        rows_end_ = std::max(rows_end_, rows[i] + 1);
+      }
+  }
+
+  /**
+   * Returns the least length of a column that has the selected rows: one
+   * past the last selected row, or zero if none are selected.
+   */
+  long get_rows_end() const { return rows_end_; }
+
   virtual int get_width() const override { return width_; }
-  virtual long get_length() const override { return length_; }
+
+  virtual long
+  get_length()
+    const override
+  {
+    return rows_ == nullptr ? length_ : num_rows_;
+  }
+
+  virtual bool
+  is_thread_safe()
+    const override
+  {
+    for (auto const& col : columns_)
+      if (!col->is_thread_safe())
+        return false;
+    return true;
+  }
+
+  /**
+   * Returns the most bytes a row may take, the sum of its columns', or
+   * `NO_MAX_BYTES` if any column has no bound.  Rows of such a table are
+   * rendered by way of strings, serially.
+   */
+  virtual int get_max_bytes() const override { return max_bytes_; }
+
+  /**
+   * Formats row 'index' into 'out', which must have room for
+   * 'get_max_bytes()' bytes.  Returns the end of the output.
+   */
+  char*
+  format_row_into(
+    long const index,
+    char* out)
+    const
+  {
+    assert(max_bytes_ != NO_MAX_BYTES);
+    long const row = rows_ == nullptr ? index : rows_[index];
+    for (auto const& col : columns_)
+      out = col->format_into(row, out);
+    return out;
+  }
+
+  virtual char*
+  format_into(
+    long const index,
+    char* const out)
+    const override
+  {
+    return format_row_into(index, out);
+  }
+
+  /**
+   * Formats rows 'begin' through 'end', column by column.
+   *
+   * With a selection, formats each run of consecutive selected rows as a
+   * block, so that filtered rows still take columns' batch paths.
+   */
+  virtual void
+  format(
+    long const begin,
+    long const end,
+    char** const pos)
+    const override
+  {
+    if (rows_ == nullptr) {
+      for (auto const& col : columns_)
+        col->format(begin, end, pos);
+      return;
+    }
+
+    // Find the runs of consecutive rows.
+    std::vector<long> runs;
+    for (long i = begin; i < end; ++i)
+      if (i == begin || rows_[i] != rows_[i - 1] + 1)
+        runs.push_back(i);
+    runs.push_back(end);
+
+    for (auto const& col : columns_)
+      for (size_t r = 0; r + 1 < runs.size(); ++r) {
+        long const row = rows_[runs[r]];
+        col->format(
+          row, row + (runs[r + 1] - runs[r]), pos + (runs[r] - begin));
+      }
+  }
+
+  /**
+   * Renders rows 'begin' through 'end' to 'sink', in order.
+   *
+   * Rows are formatted a tile of 'tile_size' at a time, column by column,
+   * each row into its own slot of a row-major buffer.  Each column's values
+   * are thus read sequentially, and formatters' batch paths run over the
+   * whole tile.
+   */
+  void
+  render(
+    long const begin,
+    long const end,
+    Sink& sink,
+    long const tile_size=TILE_SIZE)
+    const
+  {
+    assert(0 <= begin && begin <= end && end <= get_length());
+    assert(tile_size > 0);
+    if (max_bytes_ == NO_MAX_BYTES) {
+      for (long i = begin; i < end; ++i) {
+        string const row = (*this)(i);
+        sink(i, row.data(), row.size());
+      }
+      return;
+    }
+
+    long const num = std::min(end - begin, tile_size);
+    std::vector<char> buf(num * max_bytes_);
+    std::vector<char*> pos(num);
+
+    for (long tile = begin; tile < end; tile += num) {
+      long const tile_end = std::min(tile + num, end);
+      format_rows(tile, tile_end, buf.data(), pos.data(), num);
+      emit_rows(tile, tile_end, buf.data(), pos.data(), sink);
+    }
+  }
+
+  /**
+   * Renders rows 'begin' through 'end' to 'sink', in order, formatting
+   * blocks of 'block_size' rows concurrently on 'num_threads' threads.
+   *
+   * Each block is formatted into its own buffer, a tile at a time as by
+   * `render()`.  The calling thread passes finished blocks to 'sink' in
+   * order, so the sink need not be thread safe.  At most 'max_blocks'
+   * blocks are in flight at once, bounding memory; zero for twice the
+   * number of threads.  'num_threads' zero uses all hardware threads.
+   *
+   * Renders serially if there is only one thread or one block, if any
+   * column is not thread safe, or if rows have no bound on their bytes.  An
+   * exception from formatting or from the sink stops the threads and is
+   * rethrown.
+   */
+  void render_parallel(
+    long begin, long end, Sink& sink, int num_threads=0,
+    long block_size=BLOCK_SIZE, int max_blocks=0) const;
+
+  /**
+   * The rows shown in a limited number of lines.
+   */
+  struct Visible
+  {
+    // Number of leading and trailing rows shown.
+    long num_top;
+    long num_bottom;
+    // True if the rows between are elided, with an ellipsis line instead.
+    bool elided;
+  };
+
+  /**
+   * Returns the rows of 'length' to show in at most 'max_lines' lines: all
+   * rows if they fit; otherwise, leading rows, an ellipsis line, and
+   * trailing rows, with 'position' of the row lines above the ellipsis.
+   */
+  static Visible
+  get_visible(
+    long const length,
+    long const max_lines,
+    double const position)
+  {
+    if (length <= max_lines)
+      return {length, 0, false};
+    long const num_lines = std::max(max_lines - 1, 0L);
+    long const num_top = std::min(
+      std::max((long) (position * num_lines), 0L), num_lines);
+    return {num_top, num_lines - num_top, true};
+  }
+
+  /**
+   * Returns the rows of this table to show in at most 'max_lines' lines.
+   */
+  Visible
+  get_visible(
+    long const max_lines,
+    double const position)
+    const
+  {
+    return get_visible(get_length(), max_lines, position);
+  }
+
+  /**
+   * Renders the 'visible' rows to 'sink', and if they're elided, passes
+   * 'ellipsis' to the sink between the leading and trailing rows.  Rows are
+   * rendered as by `render_parallel()`.
+   */
+  void
+  render_visible(
+    Visible const& visible,
+    string const& ellipsis,
+    Sink& sink,
+    int const num_threads=1,
+    long const block_size=BLOCK_SIZE)
+    const
+  {
+    long const length = get_length();
+    assert(0 <= visible.num_top && 0 <= visible.num_bottom);
+    assert(visible.num_top + visible.num_bottom <= length);
+    render_parallel(0, visible.num_top, sink, num_threads, block_size);
+    if (visible.elided) {
+      sink.ellipsis(ellipsis.data(), ellipsis.size());
+      render_parallel(
+        length - visible.num_bottom, length, sink, num_threads, block_size);
+    }
+  }
 
   virtual string 
   operator()(
     long const index) 
     const override
   {
-    std::stringstream result;
-    for (auto i = columns_.begin(); i != columns_.end(); ++i)
-      result << (**i)(index);
-    return result.str();
+    if (max_bytes_ == NO_MAX_BYTES) {
+      long const row = rows_ == nullptr ? index : rows_[index];
+      string result;
+      for (auto const& col : columns_)
+        result += (*col)(row);
+      return result;
+    }
+
+    string result(max_bytes_, ' ');
+    result.resize(format_row_into(index, &result[0]) - &result[0]);
+    return result;
   }
 
 private:
 
+  /**
+   * Formats rows 'begin' through 'end' into 'buf', row 'begin + i' at
+   * 'buf + i * max_bytes_', 'tile_size' rows at a time.  Leaves the end of
+   * row 'begin + i' in 'pos[i]'.
+   */
+  void
+  format_rows(
+    long const begin,
+    long const end,
+    char* const buf,
+    char** const pos,
+    long const tile_size=TILE_SIZE)
+    const
+  {
+    for (long tile = begin; tile < end; tile += tile_size) {
+      long const tile_end = std::min(tile + tile_size, end);
+      for (long i = tile - begin; i < tile_end - begin; ++i)
+        pos[i] = buf + i * max_bytes_;
+      format(tile, tile_end, pos + (tile - begin));
+    }
+  }
+
+  /**
+   * Passes rows 'begin' through 'end', formatted by `format_rows()`, to
+   * 'sink'.
+   */
+  void
+  emit_rows(
+    long const begin,
+    long const end,
+    char const* const buf,
+    char* const* const pos,
+    Sink& sink)
+    const
+  {
+    for (long i = 0; i < end - begin; ++i) {
+      char const* const row = buf + i * max_bytes_;
+      sink(begin + i, row, pos[i] - row);
+    }
+  }
+
   std::vector<unique_ptr<Column>> columns_;
   int width_;
+  int max_bytes_;
   long length_;
 
+  // The selected rows, or null for all.
+  long const* rows_ = nullptr;
+  long num_rows_ = 0;
+  long rows_end_ = 0;
+
 };
 
 
@@ -1,38 +1,136 @@
 #include <cassert>
-#include <ctime>
+#include <cstring>
 
+#include "digits.hh"
 #include "time.hh"
 
 //------------------------------------------------------------------------------
 
 namespace fixfmt {
 
-string 
-TickTime::operator()(
-  long val) 
-  const 
+namespace {
+
+TimeZone const UTC;
+
+/*
+ * Splits whole seconds since the epoch into days and seconds of the day.
+ */
+inline void
+split_days(
+  long const whole,
+  long& days,
+  long& secs)
 {
-  if (val == NAT_VALUE)
-    return nat_;
+  days = whole / 86400;
+  secs = whole % 86400;
+  if (secs < 0) {
+    days--;
+    secs += 86400;
+  }
+}
 
-  // FIXME: Validate range.
 
-  // Find the whole number of seconds, and the fractional seconds scaled up
-  // by pow10(precision).
-  time_t whole;
-  long frac;
-  if (round_scale_) {
+/*
+ * Returns true if `vals` are nondecreasing, ignoring NaTs.
+ */
+inline bool
+is_sorted(
+  long const* const vals,
+  long const num)
+{
+  // NaT is the smallest value, so is never out of order.
+  long prev = TickTime::NAT_VALUE;
+  for (long i = 0; i < num; ++i) {
+    if (vals[i] < prev)
+      return false;
+    if (vals[i] != TickTime::NAT_VALUE)
+      prev = vals[i];
+  }
+  return true;
+}
+
+
+}  // anonymous namespace
+
+
+TickTime::Layout
+TickTime::compile(
+  string const& pattern,
+  int const precision)
+{
+  Layout layout;
+  layout.pattern = pattern;
+  string& text = layout.text;
+
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    char const c = pattern[i];
+    if (c & 0x80)
+      // Keep the width in bytes equal to the width in characters.
+      throw Error("non-ASCII character in pattern");
+    if (c != '%') {
+      text.push_back(c);
+      continue;
+    }
+    if (++i == pattern.size())
+      throw Error("incomplete field at end of pattern");
+
+    Field::Kind kind;
+    size_t width;
+    switch (pattern[i]) {
+    case '%': text.push_back('%'); continue;
+    case 'Y': kind = Field::YEAR;       width = 4; break;
+    case 'm': kind = Field::MONTH;      width = 2; break;
+    case 'd': kind = Field::DAY;        width = 2; break;
+    case 'H': kind = Field::HOUR;       width = 2; break;
+    case 'M': kind = Field::MINUTE;     width = 2; break;
+    case 'S': kind = Field::SECOND;     width = 2; break;
+    case 'f':
+      kind = Field::FRACTION;
+      width = precision == PRECISION_NONE ? 0 : 1 + precision;
+      break;
+    case 'z': kind = Field::OFFSET;     width = 6; break;
+    default:
+      throw Error(string("unknown field in pattern: %") + pattern[i]);
+    }
+
+    Field const field{kind, (int) text.size()};
+    if (kind <= Field::DAY)
+      layout.date_fields.push_back(field);
+    else if (kind <= Field::MINUTE)
+      layout.minute_fields.push_back(field);
+    else
+      layout.second_fields.push_back(field);
+    text.append(width, ' ');
+  }
+
+  return layout;
+}
+
+
+inline void
+TickTime::split(
+  long const val,
+  long& whole,
+  long& frac)
+  const
+{
+  if (period_ != PERIOD_SEC) {
+    // Whole minutes or hours.
+    whole = val * period_;
+    frac = 0;
+  }
+  else if (round_scale_) {
     // Round at required precision.
     // FIXME: Do bankers' rounding; this rounds half away from zero.
     long const rounded
       = (val > 0 ? val + round_scale_ / 2 : val - round_scale_ / 2) / round_scale_;
     // Separate whole and fractional seconds.
-    whole = (time_t) (rounded / prec_scale_);
+    whole = rounded / prec_scale_;
     frac = rounded % prec_scale_;
   }
   else {
     // More precision than available.
-    whole = (time_t) (val / scale_);
+    whole = val / scale_;
     frac = (val % scale_) * (prec_scale_ / scale_);
   }
   // Handle negative ticks.
@@ -40,40 +138,214 @@ TickTime::operator()(
     whole--;
     frac += prec_scale_;
   }
+}
+
 
-  // Break down the whole number of seconds into time components.
-  struct tm time;
-  if (gmtime_r(&whole, &time) == NULL) 
-    return bad_result_;
-
-  // Render the time in whole seconds.
-  string result(width_, '?');
-  size_t pos = strftime(&result[0], width_, "%Y-%m-%dT%H:%M:%S", &time);
-  if (pos != 19)
-    return bad_result_;
-
-  // Tack on subsecond precision, if indicated.
-  if (prec_ > 0) {
-    // Decimal point.
-    result[pos++] = '.';
-    // Render digits of the fractional seconds.
-    for (int i = 0; i < prec_; ++i) {
-      result[pos + prec_ - 1 - i] = '0' + frac % 10;
-      frac /= 10;
+inline void
+TickTime::format_date(
+  long const days,
+  char* const out)
+  const
+{
+  if (layout_.date_fields.empty())
+    return;
+
+  long year;
+  unsigned month, day;
+  days_to_civil(days, year, month, day);
+
+  for (auto const& field : layout_.date_fields) {
+    char* const o = out + field.offset;
+    switch (field.kind) {
+    case Field::YEAR:
+      write2(o    , year / 100);
+      write2(o + 2, year % 100);
+      break;
+    case Field::MONTH:  write2(o, month); break;
+    case Field::DAY:    write2(o, day); break;
+    default:            assert(false);
+    }
+  }
+}
+
+
+inline void
+TickTime::format_minute(
+  unsigned const secs,
+  char* const out)
+  const
+{
+  for (auto const& field : layout_.minute_fields) {
+    char* const o = out + field.offset;
+    switch (field.kind) {
+    case Field::HOUR:   write2(o, secs / 3600); break;
+    case Field::MINUTE: write2(o, secs / 60 % 60); break;
+    default:            assert(false);
     }
-    assert(frac == 0);
-    pos += prec_;
   }
+}
 
-  // UTC offset.
-  result[pos++] = '+';
-  result[pos++] = '0';
-  result[pos++] = '0';
-  result[pos++] = ':';
-  result[pos++] = '0';
-  result[pos++] = '0';
 
-  assert(pos == width_);
+inline void
+TickTime::format_second(
+  unsigned const sec,
+  long const frac,
+  int const offset,
+  char* const out)
+  const
+{
+  for (auto const& field : layout_.second_fields) {
+    char* const o = out + field.offset;
+    switch (field.kind) {
+    case Field::SECOND:
+      write2(o, sec);
+      break;
+
+    case Field::FRACTION:
+      // As for numbers, precision zero shows the decimal point only.
+      if (precision_ != PRECISION_NONE) {
+        o[0] = '.';
+        write_digits(o + 1, frac, prec_);
+      }
+      break;
+
+    case Field::OFFSET:
+      // UTC offset, in hours and minutes.
+      if (offset == 0)
+        memcpy(o, "+00:00", 6);
+      else {
+        unsigned const abs = offset < 0 ? -offset : offset;
+        o[0] = offset < 0 ? '-' : '+';
+        write2(o + 1, abs / 3600);
+        o[3] = ':';
+        write2(o + 4, abs / 60 % 60);
+      }
+      break;
+
+    default:
+      assert(false);
+    }
+  }
+}
+
+
+char*
+TickTime::format(
+  long const val,
+  char* out)
+  const
+{
+  if (val == NAT_VALUE) {
+    memcpy(out, nat_.data(), nat_.size());
+    return out + nat_.size();
+  }
+  if (val < min_val_ || max_val_ < val) {
+    memcpy(out, bad_result_.data(), width_);
+    return out + width_;
+  }
+
+  // Find the whole number of seconds, and the fractional seconds scaled up
+  // by pow10(precision).
+  long whole;
+  long frac;
+  split(val, whole, frac);
+  // Shift to local time.
+  int const offset = tz_ ? tz_->get_offset(whole) : 0;
+  whole += offset;
+
+  long days, secs;
+  split_days(whole, days, secs);
+  if (days < DAY_MIN || DAY_MAX < days) {
+    memcpy(out, bad_result_.data(), width_);
+    return out + width_;
+  }
+
+  memcpy(out, layout_.text.data(), width_);
+  format_date(days, out);
+  format_minute(secs, out);
+  format_second(secs % 60, frac, offset, out);
+  return out + width_;
+}
+
+
+void
+TickTime::format(
+  long const* const vals,
+  long const num,
+  char** const pos,
+  bool const sorted)
+  const
+{
+  if (!sorted && !is_sorted(vals, num)) {
+    for (long i = 0; i < num; ++i)
+      pos[i] = format(vals[i], pos[i]);
+    return;
+  }
+
+  // Offsets, for sorted times.
+  TimeZone::Cursor tz_cursor(tz_ ? *tz_ : UTC);
+
+  // The output with the fields of the current local minute rendered, which
+  // starts at `min_start` seconds since the epoch, and the day it is in.
+  // Initially empty.
+  string line = layout_.text;
+  long min_start = 1;
+  long min_end = 0;
+  long cur_day = DAY_MAX + 1;
+
+  for (long i = 0; i < num; ++i) {
+    long const val = vals[i];
+    char* out = pos[i];
+    if (val == NAT_VALUE) {
+      memcpy(out, nat_.data(), nat_.size());
+      pos[i] = out + nat_.size();
+      continue;
+    }
+    if (val < min_val_ || max_val_ < val) {
+      memcpy(out, bad_result_.data(), width_);
+      pos[i] = out + width_;
+      continue;
+    }
+
+    long whole;
+    long frac;
+    split(val, whole, frac);
+    int const offset = tz_cursor.get_offset(whole);
+    whole += offset;
+
+    if (!(min_start <= whole && whole < min_end)) {
+      // Moved to another minute.  Render the hour and minute, and the date
+      // only if we crossed into another day.
+      long days, secs;
+      split_days(whole, days, secs);
+      if (days < DAY_MIN || DAY_MAX < days) {
+        memcpy(out, bad_result_.data(), width_);
+        pos[i] = out + width_;
+        continue;
+      }
+      if (days != cur_day) {
+        format_date(days, &line[0]);
+        cur_day = days;
+      }
+      format_minute(secs, &line[0]);
+      min_start = whole - secs % 60;
+      min_end = min_start + 60;
+    }
+
+    memcpy(out, line.data(), width_);
+    format_second(whole - min_start, frac, offset, out);
+    pos[i] = out + width_;
+  }
+}
+
+
+string 
+TickTime::operator()(
+  long const val) 
+  const 
+{
+  string result(get_max_bytes(), ' ');
+  result.resize(format(val, &result[0]) - &result[0]);
   return result;
 }
 
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "math.hh"
+#include "fixfmt/date.hh"
 #include "fixfmt/text.hh"
+#include "fixfmt/tz.hh"
 
 //------------------------------------------------------------------------------
 
@@ -23,41 +31,182 @@ public:
   constexpr static long SCALE_MSEC  =       1000l;
   constexpr static long SCALE_USEC  =    1000000l;
   constexpr static long SCALE_NSEC  = 1000000000l;
+  constexpr static long SCALE_PSEC  = 1000000000000l;
+  constexpr static long SCALE_FSEC  = 1000000000000000l;
+  constexpr static long SCALE_ASEC  = 1000000000000000000l;
+
+  constexpr static long PERIOD_SEC  =    1l;
+  constexpr static long PERIOD_MIN  =   60l;
+  constexpr static long PERIOD_HOUR = 3600l;
 
   // NaT ("not a time") value used by numpy.datetime64.
   constexpr static long NAT_VALUE   = -9223372036854775807l - 1;
 
   constexpr static int PRECISION_NONE = -1;
 
+  /*
+   * The default pattern, as ISO 8601 with the UTC offset.
+   *
+   * A pattern is literal text with these fields:
+   *
+   *   %Y   four-digit year
+   *   %m   two-digit month
+   *   %d   two-digit day of month
+   *   %H   two-digit hour
+   *   %M   two-digit minute
+   *   %S   two-digit second
+   *   %f   decimal point and fractional seconds, to the precision; empty for
+   *        PRECISION_NONE
+   *   %z   UTC offset, as "+HH:MM"
+   *   %%   a literal "%"
+   *
+   * A literal "Z" in place of "%z" is correct only for times in UTC.
+   */
+  static constexpr char const* DEFAULT_PATTERN = "%Y-%m-%dT%H:%M:%S%f%z";
+
+  /*
+   * Raised for an invalid pattern.
+   */
+  class Error
+    : public std::invalid_argument
+  {
+  public:
+
+    Error(string const& message) : std::invalid_argument(message) {}
+
+  };
+
+  /*
+   * Ticks are `1 / scale` seconds, or for coarser ticks such as numpy's
+   * "m" and "h" units, `period` seconds.  At most one of these may be
+   * other than 1.  `scale` must be a power of 10.
+   *
+   * Times are shown in `tz`, with its UTC offset, or in UTC if it is null,
+   * laid out as `pattern`.
+   */
   TickTime(
     long    const  scale    =SCALE_SEC,
     int     const  precision=PRECISION_NONE,
-    string  const& nat      ="NaT")
-  : width_(25 + (precision == PRECISION_NONE ? 0 : 1 + precision)),
+    string  const& nat      ="NaT",
+    long    const  period   =PERIOD_SEC,
+    std::shared_ptr<TimeZone const> tz=nullptr,
+    string  const& pattern  =DEFAULT_PATTERN)
+  : layout_(compile(pattern, precision)),
+    width_(layout_.text.size()),
     bad_result_(width_, '#'),  // FIXME
     scale_(scale),
+    period_(period),
+    tz_(std::move(tz)),
     precision_(precision),
     nat_(palide(nat, width_, "", " ", 1, PAD_POS_LEFT_JUSTIFY)),
     prec_(precision_ == PRECISION_NONE ? 0 : precision_),
     prec_scale_(pow10(prec_)),
-    round_scale_(scale_ > prec_scale_ ? scale_ / prec_scale_ : 0)
+    round_scale_(scale_ > prec_scale_ ? scale_ / prec_scale_ : 0),
+    // Leave a day's room for the UTC offset.
+    min_val_(
+      (std::numeric_limits<long>::min() + round_scale_ + 86400) / period_),
+    max_val_(
+      (std::numeric_limits<long>::max() - round_scale_ - 86400) / period_)
   {
+    assert(scale_ > 0);
+    assert(period_ > 0);
+    assert(scale_ == 1 || period_ == 1);
   }
 
   size_t        get_width()     const { return width_; }
 
   long          get_scale()     const { return scale_; }
+  long          get_period()    const { return period_; }
+  std::shared_ptr<TimeZone const> const& 
+                get_tz()        const { return tz_; }
   int           get_precision() const { return precision_; }
   string const& get_nat()       const { return nat_; }
-  
+  string const& get_pattern()   const { return layout_.pattern; }
+
+  /*
+   * Returns the most bytes a formatted value may take.  Times are ASCII,
+   * but the NaT text may not be.
+   */
+  size_t get_max_bytes() const { return std::max(width_, nat_.size()); }
+
+  /*
+   * Formats `val` into `out`, which must have room for `get_max_bytes()`
+   * bytes.  Returns the end of the output.
+   */
+  char* format(long val, char* out) const;
+
+  /*
+   * Formats `num` values; value `i` is written at `pos[i]`, which is
+   * advanced past it.
+   *
+   * If `sorted`, values are expected to be nondecreasing, as in an event
+   * table ordered by time.  The rendered date and minute of the previous
+   * value are then kept, and only the changed trailing fields are rendered.
+   * Unsorted values are still rendered correctly, only more slowly.
+   * Otherwise, the values are checked first, and rendered this way if they
+   * are sorted anyway, as is a block of a time-ordered table column.
+   */
+  void format(
+    long const* vals, long num, char** pos, bool sorted=false) const;
+
   string operator()(long val) const;
 
 private:
 
+  /*
+   * A field in a layout: what it shows, and where.
+   */
+  struct Field
+  {
+    enum Kind { YEAR, MONTH, DAY, HOUR, MINUTE, SECOND, FRACTION, OFFSET };
+
+    Kind kind;
+    int offset;
+  };
+
+  /*
+   * A compiled pattern: the literal text, with fields at fixed offsets.
+   */
+  struct Layout
+  {
+    string pattern;
+    // The output, with literal text in place and blanks for fields.
+    string text;
+    // Fields that change at most once a day, once a minute, and otherwise.
+    std::vector<Field> date_fields;
+    std::vector<Field> minute_fields;
+    std::vector<Field> second_fields;
+  };
+
+  static Layout compile(string const& pattern, int precision);
+
+  /*
+   * Renders the date fields for day `days`, and the hour and minute fields
+   * for local time `secs` into the day.
+   */
+  inline void format_date(long days, char* out) const;
+  inline void format_minute(unsigned secs, char* out) const;
+
+  /*
+   * Renders the remaining fields: the second of the minute, fractional
+   * seconds, and UTC offset.
+   */
+  inline void format_second(
+    unsigned sec, long frac, int offset, char* out) const;
+
+  /*
+   * Splits `val` into whole seconds and fractional seconds, rounded to
+   * `prec_` digits.
+   */
+  inline void split(long val, long& whole, long& frac) const;
+
+  Layout    const layout_;
   size_t    const width_;
   string    const bad_result_;
 
   long      const scale_;
+  long      const period_;
+  std::shared_ptr<TimeZone const> const tz_;
   int       const precision_;
   string    const nat_;
 
@@ -65,6 +214,9 @@ private:
   int       const prec_;
   long      const prec_scale_;
   long      const round_scale_;
+  // Range of values that can be converted without overflow.
+  long      const min_val_;
+  long      const max_val_;
 
 };
 
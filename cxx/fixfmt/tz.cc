@@ -0,0 +1,498 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "date.hh"
+#include "tz.hh"
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+namespace {
+
+constexpr long LONG_MIN_ = std::numeric_limits<long>::min();
+constexpr long LONG_MAX_ = std::numeric_limits<long>::max();
+
+/*
+ * Formats a fixed offset as "+hh:mm", or "+hh:mm:ss" if it has seconds.
+ */
+string
+format_offset(
+  int const offset)
+{
+  int const abs = std::abs(offset);
+  char buf[16];
+  if (abs % 60 == 0)
+    snprintf(buf, sizeof(buf), "%c%02d:%02d",
+             offset < 0 ? '-' : '+', abs / 3600, abs / 60 % 60);
+  else
+    snprintf(buf, sizeof(buf), "%c%02d:%02d:%02d",
+             offset < 0 ? '-' : '+', abs / 3600, abs / 60 % 60, abs % 60);
+  return buf;
+}
+
+
+/*
+ * Reads big-endian integers from TZif data.
+ */
+class Reader
+{
+public:
+
+  Reader(string const& data) : data_(data) {}
+
+  void check(size_t const size) const
+  {
+    if (data_.size() - pos_ < size)
+      throw TimeZone::Error("truncated tzfile");
+  }
+
+  long read(int const size)
+  {
+    check(size);
+    uint64_t val = 0;
+    for (int i = 0; i < size; ++i)
+      val = val << 8 | (unsigned char) data_[pos_ + i];
+    pos_ += size;
+    // Sign-extend.
+    return size == 8 ? (long) val : (long) (int32_t) (uint32_t) val;
+  }
+
+  void skip(size_t const size) { check(size); pos_ += size; }
+
+  size_t get_pos() const { return pos_; }
+
+private:
+
+  string const& data_;
+  size_t pos_ = 0;
+
+};
+
+
+/*
+ * Parses the parts of a POSIX TZ string.
+ */
+class RuleParser
+{
+public:
+
+  RuleParser(string const& tz) : tz_(tz) {}
+
+  bool done() const { return pos_ == tz_.size(); }
+
+  char peek() const { return done() ? '\0' : tz_[pos_]; }
+
+  void expect(char const c)
+  {
+    if (peek() != c)
+      error();
+    ++pos_;
+  }
+
+  [[noreturn]] void error() const
+  {
+    throw TimeZone::Error("invalid TZ rule: " + tz_);
+  }
+
+  void name()
+  {
+    if (peek() == '<') {
+      auto const end = tz_.find('>', pos_);
+      if (end == string::npos)
+        error();
+      pos_ = end + 1;
+    }
+    else {
+      auto const start = pos_;
+      while (isalpha(peek()))
+        ++pos_;
+      if (pos_ - start < 3)
+        error();
+    }
+  }
+
+  long number()
+  {
+    if (!isdigit(peek()))
+      error();
+    long val = 0;
+    while (isdigit(peek()))
+      val = val * 10 + (tz_[pos_++] - '0');
+    return val;
+  }
+
+  /*
+   * Parses [+-]hh[:mm[:ss]], in seconds.
+   */
+  long time()
+  {
+    long sign = 1;
+    if (peek() == '+' || peek() == '-')
+      sign = tz_[pos_++] == '-' ? -1 : 1;
+    long val = number() * 3600;
+    if (peek() == ':') {
+      ++pos_;
+      val += number() * 60;
+      if (peek() == ':') {
+        ++pos_;
+        val += number();
+      }
+    }
+    return sign * val;
+  }
+
+private:
+
+  string const& tz_;
+  size_t pos_ = 0;
+
+};
+
+
+}  // anonymous namespace
+
+
+//------------------------------------------------------------------------------
+
+long
+TimeZone::Rule::Date::get_days(
+  long const year)
+  const
+{
+  bool const leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+  long const jan1 = civil_to_days(year, 1, 1);
+  switch (kind) {
+  case JULIAN:
+    // 1-365, never counting February 29.
+    return jan1 + day - 1 + (leap && day >= 60);
+
+  case ZERO_JULIAN:
+    return jan1 + day;
+
+  default:
+    {
+      long const first = civil_to_days(year, month, 1);
+      long const next
+        = month == 12 ? civil_to_days(year + 1, 1, 1)
+        : civil_to_days(year, month + 1, 1);
+      // 1970-01-01 was a Thursday.
+      long const first_weekday = ((first + 4) % 7 + 7) % 7;
+      long days = first + (weekday - first_weekday + 7) % 7 + (week - 1) * 7;
+      // Week 5 means the last such weekday.
+      while (days >= next)
+        days -= 7;
+      return days;
+    }
+  }
+}
+
+
+TimeZone::Rule
+TimeZone::Rule::parse(
+  string const& tz)
+{
+  Rule rule;
+  RuleParser parser(tz);
+
+  auto date = [&parser]() {
+    Date date;
+    if (parser.peek() == 'M') {
+      parser.expect('M');
+      date.kind = Date::MONTH_WEEK_DAY;
+      date.month = parser.number();
+      parser.expect('.');
+      date.week = parser.number();
+      parser.expect('.');
+      date.weekday = parser.number();
+      if (!(   1 <= date.month && date.month <= 12
+            && 1 <= date.week && date.week <= 5
+            && 0 <= date.weekday && date.weekday <= 6))
+        parser.error();
+    }
+    else if (parser.peek() == 'J') {
+      parser.expect('J');
+      date.kind = Date::JULIAN;
+      date.day = parser.number();
+      if (!(1 <= date.day && date.day <= 365))
+        parser.error();
+    }
+    else {
+      date.kind = Date::ZERO_JULIAN;
+      date.day = parser.number();
+      if (!(0 <= date.day && date.day <= 365))
+        parser.error();
+    }
+    if (parser.peek() == '/') {
+      parser.expect('/');
+      date.time = parser.time();
+    }
+    return date;
+  };
+
+  // POSIX offsets are west of UTC.
+  parser.name();
+  rule.std_offset = -parser.time();
+  if (!parser.done()) {
+    rule.has_dst = true;
+    parser.name();
+    rule.dst_offset
+      = parser.peek() == ',' ? rule.std_offset + 3600 : -parser.time();
+    parser.expect(',');
+    rule.start = date();
+    parser.expect(',');
+    rule.end = date();
+    if (!parser.done())
+      parser.error();
+  }
+  return rule;
+}
+
+
+void
+TimeZone::Rule::get_transitions(
+  long const year,
+  long& start_time,
+  long& end_time)
+  const
+{
+  // DST starts at a standard local time, and ends at a DST local time.
+  start_time = start.get_days(year) * 86400 + start.time - std_offset;
+  end_time = end.get_days(year) * 86400 + end.time - dst_offset;
+}
+
+
+int
+TimeZone::Rule::get_offset(
+  long const time)
+  const
+{
+  if (!has_dst)
+    return std_offset;
+
+  long days = time / 86400;
+  if (time % 86400 < 0)
+    --days;
+  long year;
+  unsigned month, day;
+  days_to_civil(std::max(std::min(days, DAY_MAX), DAY_MIN), year, month, day);
+
+  long start_time, end_time;
+  get_transitions(year, start_time, end_time);
+  bool const dst
+    = start_time < end_time
+    // Northern hemisphere.
+    ? start_time <= time && time < end_time
+    // Southern hemisphere: DST spans the new year.
+    : time < end_time || start_time <= time;
+  return dst ? dst_offset : std_offset;
+}
+
+
+//------------------------------------------------------------------------------
+
+TimeZone::TimeZone(
+  int const offset)
+: name_(format_offset(offset)),
+  offsets_{offset}
+{
+}
+
+
+std::shared_ptr<TimeZone const>
+TimeZone::load(
+  string const& name)
+{
+  if (name.empty() || name[0] == '/' || name.find("..") != string::npos)
+    throw Error("invalid time zone name: " + name);
+
+  char const* const tzdir = getenv("TZDIR");
+  string const path
+    = string(tzdir == nullptr ? ZONEINFO_DIR : tzdir) + "/" + name;
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    throw Error("unknown time zone: " + name);
+  std::stringstream data;
+  data << file.rdbuf();
+
+  return parse(name, data.str());
+}
+
+
+std::shared_ptr<TimeZone const>
+TimeZone::parse(
+  string const& name,
+  string const& data)
+{
+  Reader reader(data);
+
+  // Reads a header, and returns the version.
+  long counts[6];
+  enum { ISUTCNT, ISSTDCNT, LEAPCNT, TIMECNT, TYPECNT, CHARCNT };
+  auto header = [&]() {
+    reader.check(44);
+    if (data.compare(reader.get_pos(), 4, "TZif") != 0)
+      throw Error("not a tzfile: " + name);
+    char const version = data[reader.get_pos() + 4];
+    reader.skip(20);
+    for (auto& count : counts) {
+      count = reader.read(4);
+      if (count < 0)
+        throw Error("invalid tzfile: " + name);
+    }
+    return version;
+  };
+
+  // Size of the data block, with `time_size`-byte times.
+  auto block_size = [&](int const time_size) {
+    return
+        counts[TIMECNT] * time_size + counts[TIMECNT] + counts[TYPECNT] * 6
+      + counts[CHARCNT] + counts[LEAPCNT] * (time_size + 4)
+      + counts[ISSTDCNT] + counts[ISUTCNT];
+  };
+
+  char const version = header();
+  int time_size = 4;
+  if (version >= '2') {
+    // Skip the version 1 block, and use the version 2+ block, which has
+    // 64-bit times.
+    reader.skip(block_size(4));
+    header();
+    time_size = 8;
+  }
+  reader.check(block_size(time_size));
+
+  auto const tz = std::make_shared<TimeZone>();
+  tz->name_ = name;
+  tz->offsets_.clear();
+
+  long const num_times = counts[TIMECNT];
+  long const num_types = counts[TYPECNT];
+  if (num_types == 0)
+    throw Error("invalid tzfile: " + name);
+
+  tz->times_.reserve(num_times);
+  for (long i = 0; i < num_times; ++i)
+    tz->times_.push_back(reader.read(time_size));
+  std::vector<unsigned char> type_idxs;
+  type_idxs.reserve(num_times);
+  for (long i = 0; i < num_times; ++i) {
+    type_idxs.push_back(reader.read(1));
+    if (type_idxs.back() >= num_types)
+      throw Error("invalid tzfile: " + name);
+  }
+  std::vector<int> type_offsets;
+  for (long i = 0; i < num_types; ++i) {
+    type_offsets.push_back(reader.read(4));
+    reader.skip(2);  // isdst, desigidx
+  }
+  reader.skip(
+    counts[CHARCNT] + counts[LEAPCNT] * (time_size + 4)
+    + counts[ISSTDCNT] + counts[ISUTCNT]);
+
+  // Times before the first transition use the first type.
+  tz->offsets_.reserve(num_times + 1);
+  tz->offsets_.push_back(type_offsets[0]);
+  for (auto const idx : type_idxs)
+    tz->offsets_.push_back(type_offsets[idx]);
+  if (!std::is_sorted(tz->times_.begin(), tz->times_.end()))
+    throw Error("invalid tzfile: " + name);
+
+  // The footer, a POSIX TZ rule between newlines, for later times.
+  if (time_size == 8 && data.size() > reader.get_pos() + 1
+      && data[reader.get_pos()] == '\n') {
+    auto const start = reader.get_pos() + 1;
+    auto const end = data.find('\n', start);
+    if (end != string::npos && end > start) {
+      tz->rule_ = Rule::parse(data.substr(start, end - start));
+      tz->has_rule_ = true;
+      tz->extend_table();
+    }
+  }
+
+  return tz;
+}
+
+
+void
+TimeZone::extend_table()
+{
+  if (!rule_.has_dst)
+    // The rule is a fixed offset; nothing to precompute.
+    return;
+
+  // Start from the year of the last transition.
+  long year = 1970;
+  if (!times_.empty()) {
+    long const last = times_.back();
+    long const days = last / 86400 - (last % 86400 < 0);
+    unsigned month, day;
+    days_to_civil(std::max(std::min(days, DAY_MAX), DAY_MIN), year, month, day);
+  }
+
+  auto add = [this](long const time, int const offset) {
+    if (times_.empty() || time > times_.back()) {
+      times_.push_back(time);
+      offsets_.push_back(offset);
+    }
+  };
+
+  for (; year <= TABLE_END_YEAR; ++year) {
+    long start_time, end_time;
+    rule_.get_transitions(year, start_time, end_time);
+    if (start_time < end_time) {
+      add(start_time, rule_.dst_offset);
+      add(end_time, rule_.std_offset);
+    }
+    else {
+      add(end_time, rule_.std_offset);
+      add(start_time, rule_.dst_offset);
+    }
+  }
+}
+
+
+int
+TimeZone::get_offset(
+  long const time)
+  const
+{
+  auto const i = std::upper_bound(times_.begin(), times_.end(), time)
+    - times_.begin();
+  if (i == (long) times_.size() && has_rule_)
+    return rule_.get_offset(time);
+  else
+    return offsets_[i];
+}
+
+
+void
+TimeZone::Cursor::seek(
+  long const time)
+{
+  auto const& times = tz_.times_;
+  auto const i = std::upper_bound(times.begin(), times.end(), time)
+    - times.begin();
+  if (i == (long) times.size() && tz_.has_rule_) {
+    // Past the table; don't cache.
+    lo_ = 1;
+    hi_ = 0;
+    offset_ = tz_.rule_.get_offset(time);
+  }
+  else {
+    lo_ = i == 0 ? LONG_MIN_ : times[i - 1];
+    hi_ = i == (long) times.size() ? LONG_MAX_ : times[i];
+    offset_ = tz_.offsets_[i];
+  }
+}
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
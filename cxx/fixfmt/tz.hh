@@ -0,0 +1,175 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace fixfmt {
+
+using std::string;
+
+/*
+ * A time zone, as a table of UTC offsets between transition times.
+ *
+ * Times are seconds since 1970-01-01T00:00:00Z, and offsets are seconds
+ * east of UTC.  Leap seconds are ignored.
+ */
+class TimeZone
+{
+public:
+
+  /*
+   * Raised when a time zone cannot be loaded.
+   */
+  class Error
+    : public std::runtime_error
+  {
+  public:
+
+    Error(string const& message) : std::runtime_error(message) {}
+
+  };
+
+  /*
+   * Directory from which zones are loaded by name, unless $TZDIR is set.
+   */
+  static constexpr char const* ZONEINFO_DIR = "/usr/share/zoneinfo";
+
+  /*
+   * Transitions are precomputed from a zone's rule through the end of this
+   * year.  Later offsets are computed from the rule as needed.
+   */
+  static constexpr long TABLE_END_YEAR = 2100;
+
+  /*
+   * A zone with a fixed offset, named like "+05:30".
+   */
+  explicit TimeZone(int offset=0);
+
+  /*
+   * Loads zone `name`, such as "America/New_York", from the zoneinfo
+   * directory.
+   */
+  static std::shared_ptr<TimeZone const> load(string const& name);
+
+  /*
+   * Parses `data`, the contents of a compiled tzfile (TZif) in any version.
+   */
+  static std::shared_ptr<TimeZone const> parse(
+    string const& name, string const& data);
+
+  string const& get_name() const { return name_; }
+
+  /*
+   * Returns the UTC offset in effect at `time`, by binary search of the
+   * transitions.
+   */
+  int get_offset(long time) const;
+
+  /*
+   * Looks up offsets for nondecreasing times.  The interval between
+   * transitions containing the last time is remembered, so each lookup is
+   * usually two comparisons; unsorted times still give correct offsets.
+   */
+  class Cursor
+  {
+  public:
+
+    Cursor(TimeZone const& tz) : tz_(tz) {}
+
+    int get_offset(long const time)
+    {
+      if (!(lo_ <= time && time < hi_))
+        seek(time);
+      return offset_;
+    }
+
+  private:
+
+    void seek(long time);
+
+    TimeZone const& tz_;
+    // Interval [lo_, hi_) of times with `offset_`; initially empty.
+    long lo_ = 1;
+    long hi_ = 0;
+    int offset_ = 0;
+
+  };
+
+private:
+
+  /*
+   * A POSIX TZ rule, from a tzfile's footer, for times after the last
+   * transition.
+   */
+  struct Rule
+  {
+    /*
+     * The date of a transition, in one of the POSIX TZ forms.
+     */
+    struct Date
+    {
+      enum Kind { JULIAN, ZERO_JULIAN, MONTH_WEEK_DAY } kind = MONTH_WEEK_DAY;
+      // Day of year for JULIAN and ZERO_JULIAN.
+      int day = 0;
+      // Month 1-12, week 1-5, and weekday 0 (Sunday) - 6 for MONTH_WEEK_DAY.
+      int month = 0;
+      int week = 0;
+      int weekday = 0;
+      // Local time of the transition, in seconds; may be negative.
+      long time = 7200;
+
+      /*
+       * Returns the days since the epoch of this date in `year`.
+       */
+      long get_days(long year) const;
+    };
+
+    int std_offset = 0;
+    bool has_dst = false;
+    int dst_offset = 0;
+    Date start;
+    Date end;
+
+    /*
+     * Parses a POSIX TZ string, such as "EST5EDT,M3.2.0,M11.1.0".
+     */
+    static Rule parse(string const& tz);
+
+    /*
+     * Returns the times DST starts and ends in `year`.
+     */
+    void get_transitions(long year, long& start_time, long& end_time) const;
+
+    int get_offset(long time) const;
+  };
+
+  /*
+   * Appends the rule's transitions after the last one, through
+   * `TABLE_END_YEAR`.
+   */
+  void extend_table();
+
+  string name_;
+
+  // Sorted transition times, and `offsets_[i]` the offset in effect before
+  // `times_[i]` and after `times_[i - 1]`.  The last offset is in effect
+  // after the last transition, if there is no rule with DST.
+  std::vector<long> times_;
+  std::vector<int> offsets_;
+
+  // Rule for offsets after the last transition.
+  bool has_rule_ = false;
+  Rule rule_;
+
+};
+
+
+//------------------------------------------------------------------------------
+
+}  // namespace fixfmt
+
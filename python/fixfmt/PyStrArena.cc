@@ -0,0 +1,362 @@
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <Python.h>
+
+#include "PyStrArena.hh"
+#include "fixfmt/base.hh"
+#include "fixfmt/text.hh"
+#include "py.hh"
+
+using namespace py;
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+void tp_dealloc(PyStrArena* self)
+{
+  self->~PyStrArena();
+  self->ob_type->tp_free(self);
+}
+
+
+/**
+ * Appends a new entry.
+ */
+unsigned
+append_entry(
+  PyStrArena* const self,
+  char const* const utf8,
+  size_t const size,
+  bool const ascii)
+{
+  // ASCII without escape sequences is as long as its size.
+  int const length
+    = ascii && memchr(utf8, fixfmt::ANSI_ESCAPE, size) == nullptr ? size
+    : fixfmt::string_length(std::string(utf8, size));
+  if (!ascii)
+    self->all_ascii_ = false;
+
+  self->data_.append(utf8, size);
+  self->offsets_.push_back(self->data_.size());
+  self->lengths_.push_back(length);
+  self->max_length_ = std::max(self->max_length_, length);
+  self->max_size_ = std::max(self->max_size_, size);
+
+  return self->lengths_.size() - 1;
+}
+
+
+/**
+ * Returns the UTF-8 data of an object's 'str()', and sets 'size' and 'ascii'.
+ *
+ * 'str' holds the converted object, if conversion was necessary.
+ */
+char const*
+get_utf8(
+  Object* const obj,
+  ref<Unicode>& str,
+  Py_ssize_t& size,
+  bool& ascii)
+{
+  // Convert to str, unless it already is one.  A subclass of str may
+  // override '__str__()'.
+  Unicode* unicode;
+  if (PyUnicode_CheckExact(obj))
+    unicode = static_cast<Unicode*>(obj);
+  else {
+    str = obj->Str();
+    unicode = str;
+  }
+
+  // For compact ASCII strings, this is the string's own data, without any
+  // encoding.
+  char const* const utf8 = PyUnicode_AsUTF8AndSize(unicode, &size);
+  if (utf8 == nullptr)
+    throw Exception();
+  ascii = PyUnicode_IS_ASCII(unicode);
+  return utf8;
+}
+
+
+bool
+is_ascii(
+  char const* const str,
+  size_t const size)
+{
+  for (size_t i = 0; i < size; ++i)
+    if (str[i] & 0x80)
+      return false;
+  return true;
+}
+
+
+/**
+ * Interns strings by content.
+ */
+class Interner
+{
+public:
+
+  Interner(PyStrArena* const self) : self_(self) {}
+
+  unsigned 
+  intern(
+    char const* const utf8, 
+    size_t const size, 
+    bool const ascii)
+  {
+    std::string key(utf8, size);
+    auto const i = entries_.find(key);
+    if (i == entries_.end()) {
+      auto const entry = append_entry(self_, utf8, size, ascii);
+      entries_.emplace(std::move(key), entry);
+      return entry;
+    }
+    else
+      return i->second;
+  }
+
+private:
+
+  PyStrArena* const self_;
+  std::unordered_map<std::string, unsigned> entries_;
+
+};
+
+
+void
+init_objects(
+  PyStrArena* const self,
+  Object* const* const values,
+  long const stride,
+  bool const intern)
+{
+  ref<Unicode> str;
+  Py_ssize_t size;
+  bool ascii;
+
+  if (intern) {
+    // Intern by object identity first, then by content.
+    Interner interner(self);
+    std::unordered_map<Object*, unsigned> ids;
+    for (long i = 0; i < self->length_; ++i) {
+      Object* const obj = fixfmt::load_strided<Object*>(values, stride, i);
+      auto const id = ids.find(obj);
+      if (id == ids.end()) {
+        auto const utf8 = get_utf8(obj, str, size, ascii);
+        auto const entry = interner.intern(utf8, size, ascii);
+        ids.emplace(obj, entry);
+        self->codes_.push_back(entry);
+      }
+      else
+        self->codes_.push_back(id->second);
+    }
+  }
+  else
+    for (long i = 0; i < self->length_; ++i) {
+      auto const utf8 = get_utf8(
+        fixfmt::load_strided<Object*>(values, stride, i), str, size, ascii);
+      append_entry(self, utf8, size, ascii);
+    }
+}
+
+
+void
+init_bytes(
+  PyStrArena* const self,
+  char const* const values,
+  size_t const itemsize,
+  long const stride,
+  bool const intern)
+{
+  Interner interner(self);
+  for (long i = 0; i < self->length_; ++i) {
+    // Skip NUL padding on the right.
+    auto const ptr = values + i * stride;
+    auto const size = strnlen(ptr, itemsize);
+    auto const ascii = is_ascii(ptr, size);
+    if (intern)
+      self->codes_.push_back(interner.intern(ptr, size, ascii));
+    else
+      append_entry(self, ptr, size, ascii);
+  }
+}
+
+
+void tp_init(PyStrArena* self, Tuple* args, Dict* kw_args)
+{
+  // Construct first, so that dealloc is safe if we throw.
+  new(self) PyStrArena;
+
+  static char const* arg_names[] = {"buf", "intern", nullptr};
+  PyObject* array;
+  int intern = false;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "O|p", arg_names, &array, &intern);
+
+  BufferRef buffer(array, PyBUF_STRIDES | PyBUF_FORMAT);
+  if (buffer->ndim != 1)
+    throw TypeError("not a one-dimensional array");
+  std::string const format = buffer->format == nullptr ? "B" : buffer->format;
+  bool const objects = format == "O";
+  if (!objects && format.back() != 's')
+    throw TypeError("not an object or bytes array");
+  if (objects && buffer->itemsize != sizeof(Object*))
+    throw TypeError("wrong itemsize");
+
+  self->length_ = buffer->shape[0];
+  self->interned_ = intern;
+  self->offsets_.push_back(0);
+  if (intern)
+    self->codes_.reserve(self->length_);
+  else {
+    self->offsets_.reserve(self->length_ + 1);
+    self->lengths_.reserve(self->length_);
+  }
+
+  if (objects)
+    init_objects(
+      self, reinterpret_cast<Object* const*>(buffer->buf), 
+      buffer.get_stride(), intern);
+  else
+    init_bytes(
+      self, reinterpret_cast<char const*>(buffer->buf), buffer->itemsize, 
+      buffer.get_stride(), intern);
+}
+
+
+Py_ssize_t sq_length(PyStrArena* self)
+{
+  return self->get_length();
+}
+
+
+PySequenceMethods const tp_as_sequence = {
+  (lenfunc)         sq_length,          // sq_length
+  (binaryfunc)      nullptr,            // sq_concat
+  (ssizeargfunc)    nullptr,            // sq_repeat
+  (ssizeargfunc)    nullptr,            // sq_item
+  (void*)           nullptr,            // was_sq_slice
+  (ssizeobjargproc) nullptr,            // sq_ass_item
+  (void*)           nullptr,            // was_sq_ass_slice
+  (objobjproc)      nullptr,            // sq_contains
+  (binaryfunc)      nullptr,            // sq_inplace_concat
+  (ssizeargfunc)    nullptr,            // sq_inplace_repeat
+};
+
+
+auto methods = Methods<PyStrArena>();
+
+
+ref<Object> get_all_ascii(PyStrArena* const self, void* /* closure */)
+{
+  return Bool::from(self->all_ascii_);
+}
+
+
+ref<Object> get_dedupe_ratio(PyStrArena* const self, void* /* closure */)
+{
+  return Float::FromDouble(self->get_dedupe_ratio());
+}
+
+
+ref<Object> get_interned(PyStrArena* const self, void* /* closure */)
+{
+  return Bool::from(self->is_interned());
+}
+
+
+ref<Object> get_length(PyStrArena* const self, void* /* closure */)
+{
+  return Long::FromLong(self->get_length());
+}
+
+
+ref<Object> get_max_length(PyStrArena* const self, void* /* closure */)
+{
+  return Long::FromLong(self->max_length_);
+}
+
+
+ref<Object> get_max_size(PyStrArena* const self, void* /* closure */)
+{
+  return Long::FromLong(self->max_size_);
+}
+
+
+ref<Object> get_num_entries(PyStrArena* const self, void* /* closure */)
+{
+  return Long::FromLong(self->get_num_entries());
+}
+
+
+auto getsets = GetSets<PyStrArena>()
+  .add_get<get_all_ascii>   ("all_ascii")
+  .add_get<get_dedupe_ratio>("dedupe_ratio")
+  .add_get<get_interned>    ("interned")
+  .add_get<get_length>      ("length")
+  .add_get<get_max_length>  ("max_length")
+  .add_get<get_max_size>    ("max_size")
+  .add_get<get_num_entries> ("num_entries")
+  ;
+
+
+}  // anonymous namespace
+
+
+Type PyStrArena::type_ = PyTypeObject{
+  PyVarObject_HEAD_INIT(nullptr, 0)
+  (char const*)         "fixfmt._ext.StrArena",             // tp_name
+  (Py_ssize_t)          sizeof(PyStrArena),                 // tp_basicsize
+  (Py_ssize_t)          0,                                  // tp_itemsize
+  (destructor)          tp_dealloc,                         // tp_dealloc
+  (printfunc)           nullptr,                            // tp_print
+  (getattrfunc)         nullptr,                            // tp_getattr
+  (setattrfunc)         nullptr,                            // tp_setattr
+  (PyAsyncMethods*)     nullptr,                            // tp_as_async
+  (reprfunc)            nullptr,                            // tp_repr
+  (PyNumberMethods*)    nullptr,                            // tp_as_number
+  (PySequenceMethods*)  &tp_as_sequence,                    // tp_as_sequence
+  (PyMappingMethods*)   nullptr,                            // tp_as_mapping
+  (hashfunc)            nullptr,                            // tp_hash
+  (ternaryfunc)         nullptr,                            // tp_call
+  (reprfunc)            nullptr,                            // tp_str
+  (getattrofunc)        nullptr,                            // tp_getattro
+  (setattrofunc)        nullptr,                            // tp_setattro
+  (PyBufferProcs*)      nullptr,                            // tp_as_buffer
+  (unsigned long)       Py_TPFLAGS_DEFAULT
+                        | Py_TPFLAGS_BASETYPE,              // tp_flags
+  (char const*)         nullptr,                            // tp_doc
+  (traverseproc)        nullptr,                            // tp_traverse
+  (inquiry)             nullptr,                            // tp_clear
+  (richcmpfunc)         nullptr,                            // tp_richcompare
+  (Py_ssize_t)          0,                                  // tp_weaklistoffset
+  (getiterfunc)         nullptr,                            // tp_iter
+  (iternextfunc)        nullptr,                            // tp_iternext
+  (PyMethodDef*)        methods,                            // tp_methods
+  (PyMemberDef*)        nullptr,                            // tp_members
+  (PyGetSetDef*)        getsets,                            // tp_getset
+  (_typeobject*)        nullptr,                            // tp_base
+  (PyObject*)           nullptr,                            // tp_dict
+  (descrgetfunc)        nullptr,                            // tp_descr_get
+  (descrsetfunc)        nullptr,                            // tp_descr_set
+  (Py_ssize_t)          0,                                  // tp_dictoffset
+  (initproc)            wrap<PyStrArena, tp_init>,          // tp_init
+  (allocfunc)           nullptr,                            // tp_alloc
+  (newfunc)             PyType_GenericNew,                  // tp_new
+  (freefunc)            nullptr,                            // tp_free
+  (inquiry)             nullptr,                            // tp_is_gc
+  (PyObject*)           nullptr,                            // tp_bases
+  (PyObject*)           nullptr,                            // tp_mro
+  (PyObject*)           nullptr,                            // tp_cache
+  (PyObject*)           nullptr,                            // tp_subclasses
+  (PyObject*)           nullptr,                            // tp_weaklist
+  (destructor)          nullptr,                            // tp_del
+  (unsigned int)        0,                                  // tp_version_tag
+  (destructor)          nullptr,                            // tp_finalize
+};
+
+
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Python.h>
+
+#include "py.hh"
+
+//------------------------------------------------------------------------------
+
+/**
+ * The UTF-8 strings of an array of Python objects, each converted with 'str()'
+ * exactly once, or of an array of fixed-size UTF-8 byte strings.
+ *
+ * An arena is built once per column, used to choose the column's formatter,
+ * and then rendered from without calling back into Python.
+ *
+ * If the arena is interned, each distinct string is stored as a single entry,
+ * and 'codes_' maps each element of the array to its entry.  Otherwise, there
+ * is one entry per element.
+ */
+class PyStrArena
+  : public py::ExtensionType
+{
+public:
+
+  static py::Type type_;
+
+  /**
+   * Returns the number of elements of the array.
+   */
+  long get_length() const { return length_; }
+
+  /**
+   * Returns the number of entries, which is the number of distinct strings if
+   * the arena is interned.
+   */
+  long get_num_entries() const { return lengths_.size(); }
+
+  bool is_interned() const { return interned_; }
+
+  /**
+   * Returns the ratio of elements to entries.
+   */
+  double 
+  get_dedupe_ratio() 
+    const 
+  { 
+    return length_ == 0 ? 1 : (double) length_ / get_num_entries();
+  }
+
+  /**
+   * Returns the UTF-8 string of entry 'index', and sets 'size' to its size in
+   * bytes.
+   */
+  char const* 
+  get(
+    long const index, 
+    size_t& size) 
+    const
+  {
+    size = offsets_[index + 1] - offsets_[index];
+    return data_.data() + offsets_[index];
+  }
+
+  /**
+   * Returns true if the string of entry 'index' is ASCII without escape 
+   * sequences, so that its display length is its size.
+   */
+  bool 
+  is_plain(
+    long const index) 
+    const
+  { 
+    return (size_t) lengths_[index] == offsets_[index + 1] - offsets_[index];
+  }
+
+  // Number of elements.
+  long length_ = 0;
+  // True if strings are interned.
+  bool interned_ = false;
+
+  // Concatenated UTF-8 data of all entries.
+  std::string data_;
+  // Offsets of the entries in 'data_', plus one final offset at the end.
+  std::vector<size_t> offsets_;
+  // Display lengths of the entries.
+  std::vector<int> lengths_;
+  // If interned, the entry of each element.
+  std::vector<unsigned> codes_;
+
+  // The largest display length and the largest size in bytes.
+  int max_length_ = 0;
+  size_t max_size_ = 0;
+  // True if all strings are ASCII.
+  bool all_ascii_ = true;
+
+};
+
+
@@ -1,12 +1,17 @@
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <utility>
 
 #include "PyBool.hh"
 #include "PyNumber.hh"
+#include "PyStrArena.hh"
 #include "PyString.hh"
 #include "PyTable.hh"
+#include "PyTickDate.hh"
+#include "PyTickDuration.hh"
 #include "PyTickTime.hh"
+#include "arrow_ref.hh"
 
 using namespace py;
 using std::unique_ptr;
@@ -49,6 +54,194 @@ ref<Object> tp_call(PyTable* self, Tuple* args, Dict* kw_args)
 }
 
 
+/**
+ * Sink that collects rows as `str` objects into a list.
+ */
+class ListSink
+  : public fixfmt::Sink
+{
+public:
+
+  ListSink(List* const list, long const begin) : list_(list), begin_(begin) {}
+
+  virtual void
+  operator()(
+    long const index,
+    char const* const row,
+    size_t const size)
+    override
+  {
+    auto const str = Unicode::FromStringAndSize(const_cast<char*>(row), size);
+    list_->initialize(index - begin_, str);
+  }
+
+private:
+
+  List* const list_;
+  long const begin_;
+
+};
+
+
+/**
+ * Sink that collects rows, and any ellipsis line, into one buffer, without
+ * the GIL.  Each line is followed by 'line_end'.
+ */
+class BufferSink
+  : public fixfmt::Sink
+{
+public:
+
+  BufferSink(std::string line_end="") : line_end_(std::move(line_end)) {}
+
+  virtual void
+  operator()(
+    long const /* index */,
+    char const* const row,
+    size_t const size)
+    override
+  {
+    text.append(row, size);
+    text.append(line_end_);
+    ends.push_back(text.size());
+  }
+
+  virtual void
+  ellipsis(
+    char const* const line,
+    size_t const size)
+    override
+  {
+    (*this)(-1, line, size);
+  }
+
+  /**
+   * Returns the lines as a list of strings.
+   */
+  ref<List>
+  get_lines()
+    const
+  {
+    auto list = List::New(ends.size());
+    size_t start = 0;
+    for (size_t i = 0; i < ends.size(); ++i) {
+      auto const str = Unicode::FromStringAndSize(
+        const_cast<char*>(&text[start]), ends[i] - start);
+      list->initialize(i, str);
+      start = ends[i];
+    }
+    return list;
+  }
+
+  std::string text;
+  std::vector<size_t> ends;
+
+private:
+
+  std::string const line_end_;
+
+};
+
+
+/**
+ * Returns rows 'begin' through 'end' as a list of strings.
+ *
+ * If 'num_threads' is not 1, formats blocks of 'block_size' rows on that
+ * many threads, or on all cores if 0, with the GIL released.
+ */
+ref<Object> format_rows(PyTable* self, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] 
+    = {"begin", "end", "num_threads", "block_size", nullptr};
+  long begin;
+  long end;
+  int num_threads = 1;
+  long block_size = fixfmt::Table::BLOCK_SIZE;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "ll|$il", arg_names,
+    &begin, &end, &num_threads, &block_size);
+
+  if (begin < 0)
+    throw IndexError("negative begin");
+  if (end < begin)
+    throw IndexError("end before begin");
+  if (end > self->table_->get_length())
+    throw IndexError("end larger than length");
+  if (num_threads < 0)
+    throw ValueError("negative num_threads");
+  if (block_size <= 0)
+    throw ValueError("nonpositive block_size");
+
+  auto const& table = *self->table_;
+  if (num_threads == 1 || !table.is_thread_safe()) {
+    auto list = List::New(end - begin);
+    ListSink sink(list, begin);
+    table.render(begin, end, sink);
+    return std::move(list);
+  }
+  else {
+    BufferSink sink;
+    {
+      ReleaseGIL release;
+      table.render_parallel(begin, end, sink, num_threads, block_size);
+    }
+    return sink.get_lines();
+  }
+}
+
+
+/**
+ * Renders the leading 'num_top' and trailing 'num_bottom' rows in one call,
+ * with the line 'ellipsis' between if these are fewer than all rows.
+ *
+ * If 'line_end' is none, returns the lines as a list of strings; otherwise,
+ * as one string, each line followed by 'line_end'.  Rows are formatted
+ * without the GIL, on 'num_threads' threads as for `format_rows()`.
+ */
+ref<Object> format_visible(PyTable* self, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {
+    "num_top", "num_bottom", "ellipsis", "line_end", "num_threads",
+    "block_size", nullptr};
+  long num_top;
+  long num_bottom;
+  char const* ellipsis;
+  char const* line_end = nullptr;
+  int num_threads = 1;
+  long block_size = fixfmt::Table::BLOCK_SIZE;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "lls|$zil", arg_names,
+    &num_top, &num_bottom, &ellipsis, &line_end, &num_threads, &block_size);
+
+  auto const& table = *self->table_;
+  long const length = table.get_length();
+  if (num_top < 0 || num_bottom < 0)
+    throw IndexError("negative number of rows");
+  if (num_top + num_bottom > length)
+    throw IndexError("more rows than length");
+  if (num_threads < 0)
+    throw ValueError("negative num_threads");
+  if (block_size <= 0)
+    throw ValueError("nonpositive block_size");
+
+  fixfmt::Table::Visible const visible{
+    num_top, num_bottom, num_top + num_bottom < length};
+  BufferSink sink(line_end == nullptr ? "" : line_end);
+  if (table.is_thread_safe()) {
+    ReleaseGIL release;
+    table.render_visible(visible, ellipsis, sink, num_threads, block_size);
+  }
+  else
+    table.render_visible(visible, ellipsis, sink, 1, block_size);
+
+  if (line_end == nullptr)
+    return sink.get_lines();
+  else
+    return Unicode::FromStringAndSize(
+      const_cast<char*>(sink.text.data()), sink.text.size());
+}
+
+
 Py_ssize_t sq_length(PyTable* table)
 {
   return table->table_->get_length();
@@ -69,6 +262,20 @@ PySequenceMethods const tp_as_sequence = {
 };
 
 
+/**
+ * Adds 'column' to the table, if it has the selected rows.
+ */
+void
+add_to_table(
+  PyTable* const self,
+  std::unique_ptr<fixfmt::Column> column)
+{
+  if (column->get_length() < self->table_->get_rows_end())
+    throw IndexError("column too short for selected rows");
+  self->table_->add_column(std::move(column));
+}
+
+
 ref<Object> add_string(PyTable* self, Tuple* args, Dict* kw_args)
 {
   static char const* arg_names[] = {"str", nullptr};
@@ -85,26 +292,94 @@ ref<Object> add_string(PyTable* self, Tuple* args, Dict* kw_args)
 }
 
 
+/**
+ * Optional arguments for null entries in a column.
+ */
+struct NullArgs
+{
+  // A contiguous byte mask, nonzero for null entries.
+  Object* mask = (Object*) Py_None;
+  // A validity bitmap, with bits set for valid entries, least significant
+  // first, starting at bit 'valid_offset'.
+  Object* valid = (Object*) Py_None;
+  long valid_offset = 0;
+  // Text for null entries, and where to pad it.
+  char const* null = "";
+  float null_pad_pos = fixfmt::PAD_POS_LEFT_JUSTIFY;
+};
+
+
+/**
+ * Wraps 'column' in a 'NullableColumn', if 'args' give a mask or validity
+ * bitmap.  Holds on to the buffer ref.
+ */
+std::unique_ptr<fixfmt::Column>
+make_nullable(
+  PyTable* const self,
+  std::unique_ptr<fixfmt::Column> column,
+  NullArgs const& args)
+{
+  if (args.mask != Py_None && args.valid != Py_None)
+    throw ValueError("both mask and valid given");
+  long const length = column->get_length();
+
+  uint8_t const* mask;
+  int kind;
+  long offset = 0;
+  if (args.mask != Py_None) {
+    BufferRef buffer(args.mask, PyBUF_ND);
+    if (buffer->ndim != 1 || buffer->itemsize != 1)
+      throw TypeError("mask not a one-dimensional byte array");
+    if (buffer->shape[0] != length)
+      throw ValueError("mask length doesn't match");
+    mask = reinterpret_cast<uint8_t const*>(buffer->buf);
+    kind = fixfmt::NullableColumn::MASK_NULL_BYTES;
+    self->buffers_.push_back(std::move(buffer));
+  }
+  else if (args.valid != Py_None) {
+    if (args.valid_offset < 0)
+      throw ValueError("negative valid_offset");
+    BufferRef buffer(args.valid, PyBUF_SIMPLE);
+    if (buffer->len < (args.valid_offset + length + 7) / 8)
+      throw ValueError("valid bitmap too short");
+    mask = reinterpret_cast<uint8_t const*>(buffer->buf);
+    kind = fixfmt::NullableColumn::MASK_VALID_BITS;
+    offset = args.valid_offset;
+    self->buffers_.push_back(std::move(buffer));
+  }
+  else
+    return column;
+
+  return std::make_unique<fixfmt::NullableColumn>(
+    std::move(column), mask, kind, offset, args.null, args.null_pad_pos);
+}
+
+
 /**
  * Template method for adding a column to the table.
  *
- * 'buf' is a 'bytes' object containing contiguous values of type 'TYPE', e.g.
- * 'int' or 'double'.  'PYFMT' is a Python object that wraps a formatter for
- * 'TYPE' values.
+ * 'buf' is a 'bytes' object containing values of type 'TYPE', e.g. 'int' or
+ * 'double', possibly strided.  'PYFMT' is a Python object that wraps a
+ * formatter for 'TYPE' values.  Entries may be null, per 'NullArgs'.
  */
 template<typename TYPE, typename PYFMT>
 ref<Object> add_column(PyTable* self, Tuple* args, Dict* kw_args)
 {
   // Parse args.
-  static char const* arg_names[] = {"buf", "format", nullptr};
+  static char const* arg_names[] = {
+    "buf", "format", "mask", "valid", "valid_offset", "null", "null_pad_pos",
+    nullptr};
   PyObject* array;
   PYFMT* format;
+  NullArgs null_args;
   Arg::ParseTupleAndKeywords(
-      args, kw_args, "OO!", arg_names, 
-      &array, &PYFMT::type_, &format);
+      args, kw_args, "OO!|$OOlsf", arg_names, 
+      &array, &PYFMT::type_, &format, 
+      &null_args.mask, &null_args.valid, &null_args.valid_offset,
+      &null_args.null, &null_args.null_pad_pos);
 
   // Validate args.
-  BufferRef buffer(array, PyBUF_ND);
+  BufferRef buffer(array, PyBUF_STRIDES);
   if (buffer->ndim != 1)
     throw TypeError("not a one-dimensional array");
   if (buffer->itemsize != sizeof(TYPE))
@@ -112,10 +387,64 @@ ref<Object> add_column(PyTable* self, Tuple* args, Dict* kw_args)
 
   // Add the column.
   using Column = fixfmt::ColumnImpl<TYPE, typename PYFMT::Formatter>;
-  self->table_->add_column(std::make_unique<Column>(
+  std::unique_ptr<fixfmt::Column> column = std::make_unique<Column>(
     reinterpret_cast<TYPE*>(buffer->buf), 
     buffer->shape[0], 
-    *format->fmt_));
+    *format->fmt_,
+    buffer.get_stride());
+  // Hold on to the buffer ref.
+  self->buffers_.push_back(std::move(buffer));
+  add_to_table(self, make_nullable(self, std::move(column), null_args));
+
+  return none_ref();
+}
+
+
+/**
+ * Adds a column of bit-packed booleans.
+ *
+ * 'buf' contains the bits; entry i is bit 'offset + i'.  'bitorder' is
+ * "little", the default, if bits are numbered from the least significant bit
+ * of each byte, as in Arrow, or "big" for the most significant bit, as by
+ * 'np.packbits()' by default.
+ */
+ref<Object> add_bool_bits(PyTable* self, Tuple* args, Dict* kw_args)
+{
+  // Parse args.
+  static char const* arg_names[] 
+    = {"buf", "length", "format", "offset", "bitorder", nullptr};
+  PyObject* array;
+  long length;
+  PyBool* format;
+  long offset = 0;
+  char const* bitorder = "little";
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "OlO!|ls", arg_names,
+    &array, &length, &PyBool::type_, &format, &offset, &bitorder);
+
+  // Validate args.
+  if (length < 0)
+    throw ValueError("negative length");
+  if (offset < 0)
+    throw ValueError("negative offset");
+  bool lsb_first;
+  if (strcmp(bitorder, "big") == 0)
+    lsb_first = false;
+  else if (strcmp(bitorder, "little") == 0)
+    lsb_first = true;
+  else
+    throw ValueError("bitorder must be 'big' or 'little'");
+  BufferRef buffer(array, PyBUF_SIMPLE);
+  if (buffer->len < (offset + length + 7) / 8)
+    throw ValueError("buffer too short");
+
+  // Add the column.
+  add_to_table(self, std::make_unique<fixfmt::BitBoolColumn>(
+    reinterpret_cast<uint8_t const*>(buffer->buf),
+    offset,
+    length,
+    *format->fmt_,
+    lsb_first));
   // Hold on to the buffer ref.
   self->buffers_.push_back(std::move(buffer));
 
@@ -133,11 +462,12 @@ public:
 
   UTF8Column(
     size_t const itemsize, char* const values, long const length,
-    fixfmt::String format)
+    fixfmt::String format, long const stride)
   : itemsize_(itemsize),
     values_(values),
     length_(length),
-    format_(std::move(format))
+    format_(std::move(format)),
+    stride_(stride)
   {
   }
 
@@ -145,11 +475,14 @@ public:
 
   virtual int get_width() const override { return format_.get_width(); }
 
+  virtual int get_max_bytes() const override
+    { return format_.get_max_bytes(itemsize_); }
+
   virtual long get_length() const override { return length_; }
 
   virtual std::string operator()(long const index) const override {
     // Skip NUL padding on the right.
-    auto const ptr = values_ + index * itemsize_;
+    auto const ptr = values_ + index * stride_;
     return format_(std::string(ptr, strnlen(ptr, itemsize_)));
   }
 
@@ -159,6 +492,7 @@ private:
   char* const values_;
   long const length_;
   fixfmt::String const format_;
+  long const stride_;
 
 };
 
@@ -173,11 +507,12 @@ public:
 
   UCS32Column(
     size_t const itemsize, char* const values, long const length,
-    fixfmt::String format)
+    fixfmt::String format, long const stride)
   : itemsize_(itemsize),
     values_(values),
     length_(length),
-    format_(std::move(format))
+    format_(std::move(format)),
+    stride_(stride)
   {
     assert(itemsize % 4 == 0);
   }
@@ -186,15 +521,19 @@ public:
 
   virtual int get_width() const override { return format_.get_width(); }
 
+  // Each code point takes at most four bytes of UTF-8.
+  virtual int get_max_bytes() const override
+    { return format_.get_max_bytes(itemsize_); }
+
   virtual long get_length() const override { return length_; }
 
   virtual std::string operator()(long const index) const override {
     // Encode UTF-8 from Unicode code points.
     // FIXME: Is this always right?
-    auto const ptr = reinterpret_cast<unsigned*>(values_ + index * itemsize_);
+    auto const ptr = values_ + index * stride_;
     std::string s;
     for (size_t i = 0; i < itemsize_ / 4; i++) {
-      auto const c = ptr[i];
+      auto const c = fixfmt::load_strided<unsigned>(ptr, 4, i);
       if (c == 0)
         // Skip trailing NULs.
         break;
@@ -225,6 +564,7 @@ private:
   char* const values_;
   long const length_;
   fixfmt::String const format_;
+  long const stride_;
 
 };
 
@@ -238,15 +578,25 @@ class StrObjectColumn
 {
 public:
 
-  StrObjectColumn(Object** values, long const length, fixfmt::String format)
+  StrObjectColumn(
+    Object** values, long const length, fixfmt::String format, 
+    long const stride)
   : values_(values),
     length_(length),
-    format_(std::move(format))
+    format_(std::move(format)),
+    stride_(stride)
   {
   }
 
   virtual ~StrObjectColumn() override {}
 
+  // Converts objects with the Python API, which requires the GIL.
+  virtual bool is_thread_safe() const override { return false; }
+
+  // Objects are converted only as they're formatted, so their sizes aren't
+  // known in advance.
+  virtual int get_max_bytes() const override { return NO_MAX_BYTES; }
+
   virtual int get_width() const override { return format_.get_width(); }
 
   virtual long get_length() const override { return length_; }
@@ -254,7 +604,7 @@ public:
   virtual std::string operator()(long const index) const override
   {
     // Convert (or cast) to string.
-    auto str = values_[index]->Str();
+    auto str = fixfmt::load_strided<Object*>(values_, stride_, index)->Str();
     // Format the string.
     return format_(str->as_utf8_string());
   }
@@ -264,38 +614,62 @@ private:
   Object** const values_;
   long const length_;
   fixfmt::String const format_;
+  long const stride_;
 
 };
 
 
-ref<Object> add_tick_time_column(PyTable* self, Tuple* args, Dict* kw_args)
+/**
+ * Column of the entries of a string arena, converted in advance.
+ */
+class StrArenaColumn
+  : public fixfmt::Column
 {
-  // Parse args.
-  static char const* arg_names[] = { "buf", "format", nullptr };
-  PyObject* array;
-  PyTickTime* format;
-  Arg::ParseTupleAndKeywords(
-    args, kw_args, "OO!", arg_names,
-    &array, &PyTickTime::type_, &format);
+public:
 
-  // Validate args.
-  BufferRef buffer(array, PyBUF_ND);
-  if (buffer->ndim != 1)
-    throw TypeError("not a one-dimensional array");
-  if (buffer->itemsize != sizeof(long))
-    throw TypeError("wrong itemsize");
+  StrArenaColumn(PyStrArena const& arena, fixfmt::String format)
+  : arena_(arena),
+    format_(std::move(format))
+  {
+  }
 
-  // Add the column.
-  using Column = fixfmt::ColumnImpl<long, typename PyTickTime::Formatter>;
-  self->table_->add_column(std::make_unique<Column>(
-    reinterpret_cast<long const*>(buffer->buf),
-    buffer->shape[0], 
-    *format->fmt_));
-  // Hold on to the buffer ref.
-  self->buffers_.emplace_back(std::move(buffer));
+  virtual ~StrArenaColumn() override {}
 
-  return none_ref();
-}
+  virtual int get_width() const override { return format_.get_width(); }
+
+  virtual int get_max_bytes() const override
+    { return format_.get_max_bytes(arena_.max_size_); }
+
+  virtual long get_length() const override 
+    { return arena_.get_num_entries(); }
+
+  virtual std::string operator()(long const index) const override
+  {
+    size_t size;
+    char const* const str = arena_.get(index, size);
+
+    auto const& args = format_.get_args();
+    if (arena_.is_plain(index) 
+        && size <= (size_t) args.size 
+        && args.pad.length() == 1) {
+      // No eliding, and the length is known; pad directly.
+      size_t const pad_len = args.size - size;
+      size_t const left_len 
+        = (size_t) fixfmt::round((1 - args.pad_pos) * pad_len);
+      std::string result(args.size, args.pad[0]);
+      memcpy(&result[left_len], str, size);
+      return result;
+    }
+    else
+      return format_(std::string(str, size));
+  }
+
+private:
+
+  PyStrArena const& arena_;
+  fixfmt::String const format_;
+
+};
 
 
 ref<Object> add_utf8_column(PyTable* self, Tuple* args, Dict* kw_args)
@@ -310,16 +684,17 @@ ref<Object> add_utf8_column(PyTable* self, Tuple* args, Dict* kw_args)
     &itemsize, &array, &PyString::type_, &format);
 
   // Validate args.
-  BufferRef buffer(array, PyBUF_ND);
+  BufferRef buffer(array, PyBUF_STRIDES);
   if (buffer->ndim != 1)
     throw TypeError("not a one-dimensional array");
 
   // Add the column.
-  self->table_->add_column(std::make_unique<UTF8Column>(
+  add_to_table(self, std::make_unique<UTF8Column>(
     itemsize,            
     reinterpret_cast<char*>(buffer->buf),
     buffer->shape[0], 
-    *format->fmt_));
+    *format->fmt_,
+    buffer.get_stride()));
   // Hold on to the buffer ref.
   self->buffers_.emplace_back(std::move(buffer));
 
@@ -339,16 +714,17 @@ ref<Object> add_ucs32_column(PyTable* self, Tuple* args, Dict* kw_args)
     &itemsize, &array, &PyString::type_, &format);
 
   // Validate args.
-  BufferRef buffer(array, PyBUF_ND);
+  BufferRef buffer(array, PyBUF_STRIDES);
   if (buffer->ndim != 1)
     throw TypeError("not a one-dimensional array");
 
   // Add the column.
-  self->table_->add_column(std::make_unique<UCS32Column>(
+  add_to_table(self, std::make_unique<UCS32Column>(
     itemsize,            
     reinterpret_cast<char*>(buffer->buf),
     buffer->shape[0], 
-    *format->fmt_));
+    *format->fmt_,
+    buffer.get_stride()));
   // Hold on to the buffer ref.
   self->buffers_.emplace_back(std::move(buffer));
 
@@ -367,17 +743,18 @@ ref<Object> add_str_object_column(PyTable* self, Tuple* args, Dict* kw_args)
       &array, &PyString::type_, &format);
   
   // Validate args.
-  BufferRef buffer(array, PyBUF_ND);
+  BufferRef buffer(array, PyBUF_STRIDES);
   if (buffer->ndim != 1)
     throw TypeError("not a one-dimensional array");
   if (buffer->itemsize != sizeof(Object*))
     throw TypeError("wrong itemsize");
 
   // Add the column.
-  self->table_->add_column(std::make_unique<StrObjectColumn>(
+  add_to_table(self, std::make_unique<StrObjectColumn>(
     reinterpret_cast<Object**>(buffer->buf),
     buffer->shape[0], 
-    *format->fmt_));
+    *format->fmt_,
+    buffer.get_stride()));
   // Hold on to the buffer ref.
   self->buffers_.emplace_back(std::move(buffer));
 
@@ -385,9 +762,370 @@ ref<Object> add_str_object_column(PyTable* self, Tuple* args, Dict* kw_args)
 }
 
 
+template<typename IDXTYPE>
+void add_categorical_column(
+  PyTable* const self, BufferRef&& buffer, fixfmt::Column const& categories,
+  std::string const& missing)
+{
+  using Column = fixfmt::CategoricalColumn<IDXTYPE>;
+  add_to_table(self, std::make_unique<Column>(
+    reinterpret_cast<IDXTYPE const*>(buffer->buf),
+    buffer->shape[0],
+    categories,
+    missing,
+    buffer.get_stride()));
+  // Hold on to the buffer ref.
+  self->buffers_.emplace_back(std::move(buffer));
+}
+
+
+/**
+ * Adds a column of integer codes into categories.
+ *
+ * 'categories' is another table, each row of which is the formatted category
+ * for the corresponding code.  Each category is formatted once, here; codes
+ * that are negative or out of range are rendered as 'missing'.  Codes are
+ * signed or unsigned integers, as given by the array's format.
+ */
+ref<Object> add_categorical(PyTable* self, Tuple* args, Dict* kw_args)
+{
+  // Parse args.
+  static char const* arg_names[] = {"codes", "categories", "missing", nullptr};
+  PyObject* array;
+  PyTable* categories;
+  char const* missing = "";
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "OO!|s", arg_names,
+    &array, &PyTable::type_, &categories, &missing);
+
+  // Validate args.
+  BufferRef buffer(array, PyBUF_STRIDES | PyBUF_FORMAT);
+  if (buffer->ndim != 1)
+    throw TypeError("not a one-dimensional array");
+  auto const& cat_table = *categories->table_;
+  if (cat_table.get_length() == fixfmt::MAX_INDEX)
+    throw ValueError("categories table has no columns");
+  // The last character of a struct format is the type code.
+  char const* const format = buffer->format == nullptr ? "B" : buffer->format;
+  bool const is_unsigned = strchr("?BHILQ", format[strlen(format) - 1]);
+
+  // Add the column, with the code type given by the itemsize and format.
+  switch (buffer->itemsize * (is_unsigned ? -1 : 1)) {
+  case 1:
+    add_categorical_column<int8_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  case -1:
+    add_categorical_column<uint8_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  case 2:
+    add_categorical_column<int16_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  case -2:
+    add_categorical_column<uint16_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  case 4:
+    add_categorical_column<int32_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  case -4:
+    add_categorical_column<uint32_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  case 8:
+    add_categorical_column<int64_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  case -8:
+    add_categorical_column<uint64_t>(
+      self, std::move(buffer), cat_table, missing);
+    break;
+  default:
+    throw TypeError("wrong itemsize");
+  }
+
+  return none_ref();
+}
+
+
+ref<Object> add_str_arena_column(PyTable* self, Tuple* args, Dict* kw_args)
+{
+  // Parse args.
+  static char const* arg_names[] = {"arena", "format", nullptr};
+  PyStrArena* arena;
+  PyString* format;
+  Arg::ParseTupleAndKeywords(
+      args, kw_args, "O!O!", arg_names,
+      &PyStrArena::type_, &arena, &PyString::type_, &format);
+
+  // Add the column.
+  StrArenaColumn column(*arena, *format->fmt_);
+  if (arena->is_interned())
+    // Format each distinct string once, and look up elements' entries.
+    add_to_table(
+      self, std::make_unique<fixfmt::CategoricalColumn<unsigned>>(
+        arena->codes_.data(), arena->get_length(), column));
+  else
+    add_to_table(
+      self, std::make_unique<StrArenaColumn>(std::move(column)));
+  // Hold on to the arena.
+  self->objects_.emplace_back(ref<Object>::of(arena));
+
+  return none_ref();
+}
+
+
+//------------------------------------------------------------------------------
+// Arrow C Data Interface
+
+/**
+ * Returns the formatter wrapped by 'format', which must be a 'PYFMT'.
+ */
+template<typename PYFMT>
+typename PYFMT::Formatter const&
+get_arrow_format(
+  PyObject* const format,
+  char const* const arrow_format)
+{
+  if (!PyObject_TypeCheck(format, &PYFMT::type_))
+    throw TypeError(
+      std::string("wrong formatter type for Arrow format ") + arrow_format);
+  return *((PYFMT*) format)->fmt_;
+}
+
+
+template<typename IDXTYPE>
+unique_ptr<fixfmt::Column>
+make_arrow_categorical(
+  ArrowArray const& array,
+  fixfmt::Column const& categories)
+{
+  return std::make_unique<fixfmt::CategoricalColumn<IDXTYPE>>(
+    fixfmt::get_arrow_buffer<IDXTYPE>(array, 1) + array.offset,
+    array.length,
+    categories);
+}
+
+
+/**
+ * Makes a column for an Arrow array, without copying its data.
+ *
+ * 'format' is the formatter for the array's values or, for a dictionary
+ * array, for the values of its dictionary, each of which is formatted once.
+ * Null entries are shown as 'null'.
+ */
+unique_ptr<fixfmt::Column>
+make_arrow_column(
+  ArrowSchema const& schema,
+  ArrowArray const& array,
+  PyObject* const format,
+  std::string const& null,
+  float const null_pad_pos)
+{
+  char const* const fmt = schema.format;
+  unique_ptr<fixfmt::Column> column;
+
+  if (schema.dictionary != nullptr) {
+    if (array.dictionary == nullptr)
+      throw ValueError("Arrow dictionary array missing");
+    auto const categories = make_arrow_column(
+      *schema.dictionary, *array.dictionary, format, null, null_pad_pos);
+    // The indices are signed or unsigned integers.
+    switch (fmt[0] == '\0' || fmt[1] != '\0' ? '\0' : fmt[0]) {
+    case 'c':
+      column = make_arrow_categorical<int8_t>(array, *categories);
+      break;
+    case 'C':
+      column = make_arrow_categorical<uint8_t>(array, *categories);
+      break;
+    case 's':
+      column = make_arrow_categorical<int16_t>(array, *categories);
+      break;
+    case 'S':
+      column = make_arrow_categorical<uint16_t>(array, *categories);
+      break;
+    case 'i':
+      column = make_arrow_categorical<int32_t>(array, *categories);
+      break;
+    case 'I':
+      column = make_arrow_categorical<uint32_t>(array, *categories);
+      break;
+    case 'l':
+      column = make_arrow_categorical<int64_t>(array, *categories);
+      break;
+    case 'L':
+      column = make_arrow_categorical<uint64_t>(array, *categories);
+      break;
+    default:
+      throw TypeError(std::string("bad Arrow dictionary index format ") + fmt);
+    }
+  }
+
+  else if (array.n_children != 0)
+    throw TypeError(std::string("unsupported nested Arrow format ") + fmt);
+
+  else if (strcmp(fmt, "b") == 0)
+    column = fixfmt::make_arrow_bool_column(
+      array, get_arrow_format<PyBool>(format, fmt));
+
+  else if (strcmp(fmt, "u") == 0)
+    column = std::make_unique<fixfmt::ArrowStringColumn<int32_t>>(
+      array, get_arrow_format<PyString>(format, fmt));
+  else if (strcmp(fmt, "U") == 0)
+    column = std::make_unique<fixfmt::ArrowStringColumn<int64_t>>(
+      array, get_arrow_format<PyString>(format, fmt));
+
+  // Timestamps, with a unit and optional time zone, as "tsu:UTC".  The
+  // formatter carries the tick scale and the zone.
+  else if (strncmp(fmt, "ts", 2) == 0 && fmt[2] != '\0' && fmt[3] == ':')
+    column = fixfmt::make_arrow_primitive_column<int64_t>(
+      array, get_arrow_format<PyTickTime>(format, fmt));
+  // Durations, as "tDn".
+  else if (strncmp(fmt, "tD", 2) == 0 && fmt[2] != '\0' && fmt[3] == '\0')
+    column = fixfmt::make_arrow_primitive_column<int64_t>(
+      array, get_arrow_format<PyTickDuration>(format, fmt));
+
+  else if (fmt[0] != '\0' && fmt[1] == '\0') {
+    auto const& number = get_arrow_format<PyNumber>(format, fmt);
+    switch (fmt[0]) {
+    case 'c':
+      column = fixfmt::make_arrow_primitive_column<int8_t>(array, number);
+      break;
+    case 'C':
+      column = fixfmt::make_arrow_primitive_column<uint8_t>(array, number);
+      break;
+    case 's':
+      column = fixfmt::make_arrow_primitive_column<int16_t>(array, number);
+      break;
+    case 'S':
+      column = fixfmt::make_arrow_primitive_column<uint16_t>(array, number);
+      break;
+    case 'i':
+      column = fixfmt::make_arrow_primitive_column<int32_t>(array, number);
+      break;
+    case 'I':
+      column = fixfmt::make_arrow_primitive_column<uint32_t>(array, number);
+      break;
+    case 'l':
+      column = fixfmt::make_arrow_primitive_column<int64_t>(array, number);
+      break;
+    case 'L':
+      column = fixfmt::make_arrow_primitive_column<uint64_t>(array, number);
+      break;
+    case 'f':
+      column = fixfmt::make_arrow_primitive_column<float>(array, number);
+      break;
+    case 'g':
+      column = fixfmt::make_arrow_primitive_column<double>(array, number);
+      break;
+    }
+  }
+
+  if (!column)
+    throw TypeError(std::string("unsupported Arrow format ") + fmt);
+  return fixfmt::make_arrow_nullable(
+    array, std::move(column), null, null_pad_pos);
+}
+
+
+/**
+ * Adds a column for an Arrow array, without copying its data.
+ *
+ * 'array' implements the Arrow PyCapsule interface, or is a (schema, array)
+ * pair of capsules, or is a list of these, the chunks of one column, which
+ * are rendered in place, without concatenating them.  'format' is the
+ * formatter for the array's values; for a dictionary array, for its
+ * dictionary's values.  Null entries are shown as
+ * 'null', padded per 'null_pad_pos'.
+ */
+ref<Object> add_arrow(PyTable* self, Tuple* args, Dict* kw_args)
+{
+  // Parse args.
+  static char const* arg_names[] = {
+    "array", "format", "null", "null_pad_pos", nullptr};
+  PyObject* array_obj;
+  PyObject* format;
+  char const* null = "";
+  float null_pad_pos = fixfmt::PAD_POS_LEFT_JUSTIFY;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "OO|$sf", arg_names, 
+    &array_obj, &format, &null, &null_pad_pos);
+
+  if (PyList_Check(array_obj)) {
+    // A list of chunks.
+    long const width
+      = ((Object*) format)->GetAttrString("width")->long_value();
+    auto column = std::make_unique<fixfmt::ChunkedColumn>(width);
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(array_obj); ++i) {
+      ArrowRef arrow(PyList_GET_ITEM(array_obj, i));
+      auto chunk = make_arrow_column(
+        *arrow.schema, *arrow.array, format, null, null_pad_pos);
+      if (chunk->get_width() != width)
+        throw ValueError("chunk width doesn't match");
+      column->add_chunk(std::move(chunk));
+      // Hold on to the capsules, which own the data.
+      self->objects_.emplace_back(std::move(arrow.capsules));
+    }
+    add_to_table(self, std::move(column));
+  }
+
+  else {
+    ArrowRef arrow(array_obj);
+    add_to_table(self, make_arrow_column(
+      *arrow.schema, *arrow.array, format, null, null_pad_pos));
+    // Hold on to the capsules, which own the data.
+    self->objects_.emplace_back(std::move(arrow.capsules));
+  }
+
+  return none_ref();
+}
+
+
+/**
+ * Selects the rows to show, an int64 array of row indices into the columns,
+ * or none for all rows.  The rows are not copied.
+ */
+ref<Object> select(PyTable* self, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {"rows", nullptr};
+  PyObject* rows_arg;
+  Arg::ParseTupleAndKeywords(args, kw_args, "O", arg_names, &rows_arg);
+
+  auto& table = *self->table_;
+  table.select(nullptr, 0);
+  self->rows_.reset();
+  if (rows_arg == Py_None)
+    return none_ref();
+
+  auto rows = std::make_unique<BufferRef>(
+    rows_arg, PyBUF_ND | PyBUF_FORMAT);
+  char const* const format = (*rows)->format;
+  if ((*rows)->ndim != 1 || (*rows)->itemsize != sizeof(long)
+      || format == nullptr
+      || !(strcmp(format, "l") == 0 || strcmp(format, "q") == 0))
+    throw TypeError("rows not a one-dimensional int64 array");
+  long const* const indices = (long const*) (*rows)->buf;
+  long const num_rows = (*rows)->shape[0];
+  long const length = table.get_length();
+  for (long i = 0; i < num_rows; ++i)
+    if (indices[i] < 0 || indices[i] >= length)
+      throw IndexError("row out of range");
+
+  table.select(indices, num_rows);
+  self->rows_ = std::move(rows);
+  return none_ref();
+}
+
+
 auto methods = Methods<PyTable>()
   .add<add_string>                              ("add_string")
+  .add<add_arrow>                               ("add_arrow")
+  .add<add_categorical>                         ("add_categorical")
   .add<add_column<bool,             PyBool>>    ("add_bool")
+  .add<add_bool_bits>                           ("add_bool_bits")
   .add<add_column<char,             PyNumber>>  ("add_int8")
   .add<add_column<short,            PyNumber>>  ("add_int16")
   .add<add_column<int,              PyNumber>>  ("add_int32")
@@ -398,10 +1136,16 @@ auto methods = Methods<PyTable>()
   .add<add_column<unsigned long,    PyNumber>>  ("add_uint64")
   .add<add_column<float,            PyNumber>>  ("add_float32")
   .add<add_column<double,           PyNumber>>  ("add_float64")
-  .add<add_tick_time_column>                    ("add_tick_time")
+  .add<add_column<long,             PyTickDate>>("add_tick_date")
+  .add<add_column<long,             PyTickDuration>>("add_tick_duration")
+  .add<add_column<long,             PyTickTime>>("add_tick_time")
   .add<add_utf8_column>                         ("add_utf8")
   .add<add_ucs32_column>                        ("add_ucs32")
   .add<add_str_object_column>                   ("add_str_object")
+  .add<add_str_arena_column>                    ("add_str_arena")
+  .add<format_rows>                             ("format_rows")
+  .add<format_visible>                          ("format_visible")
+  .add<select>                                  ("select")
 ;
 
 
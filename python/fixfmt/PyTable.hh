@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <Python.h>
 
@@ -23,6 +24,12 @@ public:
   // Holds references to the buffers referenced by the table's columns.
   std::vector<py::BufferRef> buffers_;
 
+  // Holds references to other objects referenced by the table's columns.
+  std::vector<py::ref<py::Object>> objects_;
+
+  // Holds a reference to the buffer of selected rows, if any.
+  std::unique_ptr<py::BufferRef> rows_;
+
 };
 
 
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <sstream>
 
 #include <Python.h>
 
@@ -16,20 +17,44 @@ namespace {
 
 int tp_init(PyTickDate* self, PyObject* args, PyObject* kw_args)
 {
-  static char const* arg_names[] = { nullptr };
-  if (!PyArg_ParseTupleAndKeywords(args, kw_args, "", (char**) arg_names))
+  static char const* arg_names[]
+    = { "min_val", "max_val", "unit", "nat", nullptr };
+  long min_val = 1;
+  long max_val = 0;
+  int unit = fixfmt::TickDate::UNIT_DAY;
+  char const* nat = "NaT";
+  if (!PyArg_ParseTupleAndKeywords(
+        args, kw_args, "|ll$Cs", (char**) arg_names,
+        &min_val, &max_val, &unit, &nat))
     return -1;
 
-  // FIXME: Validate args.
+  if (!(   unit == fixfmt::TickDate::UNIT_DAY
+        || unit == fixfmt::TickDate::UNIT_WEEK
+        || unit == fixfmt::TickDate::UNIT_MONTH
+        || unit == fixfmt::TickDate::UNIT_YEAR)) {
+    PyErr_SetString(PyExc_ValueError, "unit must be 'D', 'W', 'M', or 'Y'");
+    return -1;
+  }
 
-  new(self) PyTickDate(make_unique<fixfmt::TickDate>());
+  new(self) PyTickDate(
+    make_unique<fixfmt::TickDate>(min_val, max_val, unit, nat));
   return 0;
 }
 
 
 ref<Unicode> tp_repr(PyTickDate* self)
 {
-  return Unicode::from("TickDate()");
+  auto const& fmt = self->fmt_;
+  std::stringstream ss;
+  ss << "TickDate(";
+  if (fmt->get_min_val() <= fmt->get_max_val())
+    ss << fmt->get_min_val() << ", " << fmt->get_max_val() << ", ";
+  ss << "unit='" << fmt->get_unit() << "'";
+  // Show the NaT text only if it isn't the default.
+  if (fmt->get_nat() != fixfmt::TickDate(1, 0, fmt->get_unit()).get_nat())
+    ss << ", nat=\"" << fmt->get_nat() << "\"";
+  ss << ")";
+  return Unicode::from(ss.str());
 }
 
 
@@ -52,7 +77,43 @@ ref<Object> get_width(PyTickDate* const self, void* /* closure */)
 }
 
 
+ref<Object> get_max_val(PyTickDate* const self, void* /* closure */)
+{
+  auto const& fmt = self->fmt_;
+  return
+      fmt->get_min_val() <= fmt->get_max_val()
+    ? (ref<Object>) Long::FromLong(fmt->get_max_val())
+    : none_ref();
+}
+
+
+ref<Object> get_min_val(PyTickDate* const self, void* /* closure */)
+{
+  auto const& fmt = self->fmt_;
+  return
+      fmt->get_min_val() <= fmt->get_max_val()
+    ? (ref<Object>) Long::FromLong(fmt->get_min_val())
+    : none_ref();
+}
+
+
+ref<Object> get_nat(PyTickDate* const self, void* /* closure */)
+{
+  return Unicode::from(self->fmt_->get_nat());
+}
+
+
+ref<Object> get_unit(PyTickDate* const self, void* /* closure */)
+{
+  return Unicode::from(std::string(1, self->fmt_->get_unit()));
+}
+
+
 auto getsets = GetSets<PyTickDate>()
+  .add_get<get_max_val>     ("max_val")
+  .add_get<get_min_val>     ("min_val")
+  .add_get<get_nat>         ("nat")
+  .add_get<get_unit>        ("unit")
   .add_get<get_width>       ("width")
   ;
 
@@ -0,0 +1,218 @@
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <Python.h>
+
+#include "PyTickDuration.hh"
+#include "fixfmt.hh"
+#include "py.hh"
+
+using namespace py;
+using std::string;
+using std::make_unique;
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+using Formatter = fixfmt::TickDuration;
+
+char const* const STYLE_NAMES[] = {"clock", "compact"};
+
+int
+get_precision(
+  Object* arg)
+{
+  int precision;
+  if (arg == Py_None)
+    precision = Formatter::PRECISION_NONE;
+  else {
+    precision = arg->long_value();
+    if (precision < 0)
+      precision = Formatter::PRECISION_NONE;
+    else if (precision > 18)
+      throw ValueError("precision too large");
+  }
+  return precision;
+}
+
+
+int
+parse_style(
+  char const* const name)
+{
+  for (int style : {Formatter::STYLE_CLOCK, Formatter::STYLE_COMPACT})
+    if (strcmp(name, STYLE_NAMES[style]) == 0)
+      return style;
+  throw ValueError(string("unknown style: ") + name);
+}
+
+
+void tp_init(PyTickDuration* self, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {
+    "scale", "precision", "style", "day_digits", "nat", "period", nullptr };
+  long          scale           = 1;
+  Object*       precision_arg   = (Object*) Py_None;
+  char const*   style_name      = "clock";
+  int           day_digits      = 1;
+  char const*   nat             = "NaT";
+  long          period          = 1;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "|lO$sietl", arg_names,
+    &scale, &precision_arg, &style_name, &day_digits, "utf-8", &nat, &period);
+
+  if (scale <= 0) 
+    throw ValueError("nonpositive scale");
+  if (period <= 0)
+    throw ValueError("nonpositive period");
+  if (scale != 1 && period != 1)
+    throw ValueError("scale and period may not both be other than 1");
+  if (!(0 < day_digits && day_digits < 19))
+    throw ValueError("day_digits out of range");
+  auto const precision = get_precision(precision_arg);
+  auto const style = parse_style(style_name);
+
+  new(self) PyTickDuration(make_unique<Formatter>(
+    scale, precision, style, day_digits, nat, period));
+}
+
+
+ref<Unicode> tp_repr(PyTickDuration* self)
+{
+  auto const& fmt = self->fmt_;
+  std::stringstream ss;
+  ss << "TickDuration(" << fmt->get_scale() << ", " << fmt->get_precision()
+     << ", style=\"" << STYLE_NAMES[fmt->get_style()]
+     << "\", day_digits=" << fmt->get_day_digits()
+     << ", nat=\"" << fmt->get_nat() << "\"";
+  if (fmt->get_period() != 1)
+    ss << ", period=" << fmt->get_period();
+  ss << ")";
+  return Unicode::from(ss.str());
+}
+
+
+ref<Object> tp_call(PyTickDuration* self, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = { "value", nullptr };
+  long val;
+  Arg::ParseTupleAndKeywords(args, kw_args, "l", arg_names, &val);
+
+  return Unicode::from((*(self->fmt_))(val));
+}
+
+
+auto methods = Methods<PyTickDuration>();
+
+
+ref<Object> get_day_digits(PyTickDuration* const self, void* /* closure */)
+{
+  return Long::FromLong(self->fmt_->get_day_digits());
+}
+
+
+ref<Object> get_nat(PyTickDuration* const self, void* /* closure */)
+{
+  return Unicode::from(self->fmt_->get_nat());
+}
+
+
+ref<Object> get_period(PyTickDuration* const self, void* /* closure */)
+{
+  return Long::FromLong(self->fmt_->get_period());
+}
+
+
+ref<Object> get_precision(PyTickDuration* const self, void* /* closure */)
+{
+  return Long::FromLong(self->fmt_->get_precision());
+}
+
+
+ref<Object> get_scale(PyTickDuration* const self, void* /* closure */)
+{
+  return Long::FromLong(self->fmt_->get_scale());
+}
+
+
+ref<Object> get_style(PyTickDuration* const self, void* /* closure */)
+{
+  return Unicode::from(STYLE_NAMES[self->fmt_->get_style()]);
+}
+
+
+ref<Object> get_width(PyTickDuration* const self, void* /* closure */)
+{
+  return Long::FromLong(self->fmt_->get_width());
+}
+
+
+auto getsets = GetSets<PyTickDuration>()
+  .add_get<get_day_digits>  ("day_digits")
+  .add_get<get_nat>         ("nat")
+  .add_get<get_period>      ("period")
+  .add_get<get_precision>   ("precision")
+  .add_get<get_scale>       ("scale")
+  .add_get<get_style>       ("style")
+  .add_get<get_width>       ("width")
+  ;
+
+
+}  // anonymous namespace
+
+
+Type PyTickDuration::type_ = PyTypeObject{
+  PyVarObject_HEAD_INIT(nullptr, 0)
+  (char const*)         "fixfmt._ext.TickDuration",         // tp_name
+  (Py_ssize_t)          sizeof(PyTickDuration),                 // tp_basicsize
+  (Py_ssize_t)          0,                                  // tp_itemsize
+  (destructor)          nullptr,                            // tp_dealloc
+  (printfunc)           nullptr,                            // tp_print
+  (getattrfunc)         nullptr,                            // tp_getattr
+  (setattrfunc)         nullptr,                            // tp_setattr
+  (PyAsyncMethods*)     nullptr,                            // tp_as_async
+  (reprfunc)            wrap<PyTickDuration, tp_repr>,          // tp_repr
+  (PyNumberMethods*)    nullptr,                            // tp_as_number
+  (PySequenceMethods*)  nullptr,                            // tp_as_sequence
+  (PyMappingMethods*)   nullptr,                            // tp_as_mapping
+  (hashfunc)            nullptr,                            // tp_hash
+  (ternaryfunc)         wrap<PyTickDuration, tp_call>,          // tp_call
+  (reprfunc)            nullptr,                            // tp_str
+  (getattrofunc)        nullptr,                            // tp_getattro
+  (setattrofunc)        nullptr,                            // tp_setattro
+  (PyBufferProcs*)      nullptr,                            // tp_as_buffer
+  (unsigned long)       Py_TPFLAGS_DEFAULT
+                        | Py_TPFLAGS_BASETYPE,              // tp_flags
+  (char const*)         nullptr,                            // tp_doc
+  (traverseproc)        nullptr,                            // tp_traverse
+  (inquiry)             nullptr,                            // tp_clear
+  (richcmpfunc)         nullptr,                            // tp_richcompare
+  (Py_ssize_t)          0,                                  // tp_weaklistoffset
+  (getiterfunc)         nullptr,                            // tp_iter
+  (iternextfunc)        nullptr,                            // tp_iternext
+  (PyMethodDef*)        methods,                            // tp_methods
+  (PyMemberDef*)        nullptr,                            // tp_members
+  (PyGetSetDef*)        getsets,                            // tp_getset
+  (_typeobject*)        nullptr,                            // tp_base
+  (PyObject*)           nullptr,                            // tp_dict
+  (descrgetfunc)        nullptr,                            // tp_descr_get
+  (descrsetfunc)        nullptr,                            // tp_descr_set
+  (Py_ssize_t)          0,                                  // tp_dictoffset
+  (initproc)            wrap<PyTickDuration, tp_init>,          // tp_init
+  (allocfunc)           nullptr,                            // tp_alloc
+  (newfunc)             PyType_GenericNew,                  // tp_new
+  (freefunc)            nullptr,                            // tp_free
+  (inquiry)             nullptr,                            // tp_is_gc
+  (PyObject*)           nullptr,                            // tp_bases
+  (PyObject*)           nullptr,                            // tp_mro
+  (PyObject*)           nullptr,                            // tp_cache
+  (PyObject*)           nullptr,                            // tp_subclasses
+  (PyObject*)           nullptr,                            // tp_weaklist
+  (destructor)          nullptr,                            // tp_del
+  (unsigned int)        0,                                  // tp_version_tag
+  (destructor)          nullptr,                            // tp_finalize
+};
+
+
@@ -26,28 +26,70 @@ get_precision(
     precision = arg->long_value();
     if (precision < 0)
       precision = fixfmt::TickTime::PRECISION_NONE;
+    else if (precision > 18)
+      throw ValueError("precision too large");
   }
   return precision;
 }
 
 
-int tp_init(PyTickTime* self, Tuple* args, Dict* kw_args)
+/*
+ * Returns the time zone for a `tz` argument: None for UTC, a zone name, or a
+ * fixed offset in seconds east of UTC.
+ */
+std::shared_ptr<fixfmt::TimeZone const>
+load_tz(
+  Object* arg)
+{
+  if (arg == Py_None)
+    return nullptr;
+  else if (Unicode::Check(arg))
+    try {
+      return fixfmt::TimeZone::load(static_cast<Unicode*>(arg)->as_utf8());
+    }
+    catch (fixfmt::TimeZone::Error const& err) {
+      throw ValueError(err.what());
+    }
+  else {
+    long const offset = arg->long_value();
+    if (!(-86400 < offset && offset < 86400))
+      throw ValueError("offset out of range");
+    return std::make_shared<fixfmt::TimeZone>(offset);
+  }
+}
+
+
+void tp_init(PyTickTime* self, Tuple* args, Dict* kw_args)
 {
   static char const* arg_names[] = {
-    "scale", "precision", "nat", nullptr };
+    "scale", "precision", "nat", "period", "tz", "pattern", nullptr };
   long          scale           = fixfmt::TickTime::SCALE_SEC;
   Object*       precision_arg   = (Object*) Py_None;
   char const*   nat             = "NaT";
+  long          period          = fixfmt::TickTime::PERIOD_SEC;
+  Object*       tz_arg          = (Object*) Py_None;
+  char const*   pattern         = fixfmt::TickTime::DEFAULT_PATTERN;
   Arg::ParseTupleAndKeywords(
-    args, kw_args, "|lO$et", arg_names,
-    &scale, &precision_arg, "utf-8", &nat);
+    args, kw_args, "|lO$etlOet", arg_names,
+    &scale, &precision_arg, "utf-8", &nat, &period, &tz_arg,
+    "utf-8", &pattern);
 
   if (scale <= 0) 
     throw ValueError("nonpositive scale");
+  if (period <= 0)
+    throw ValueError("nonpositive period");
+  if (scale != 1 && period != 1)
+    throw ValueError("scale and period may not both be other than 1");
   auto const precision = get_precision(precision_arg);
+  auto tz = load_tz(tz_arg);
 
-  new(self) PyTickTime(make_unique<fixfmt::TickTime>(scale, precision, nat));
-  return 0;
+  try {
+    new(self) PyTickTime(make_unique<fixfmt::TickTime>(
+      scale, precision, nat, period, std::move(tz), pattern));
+  }
+  catch (fixfmt::TickTime::Error const& err) {
+    throw ValueError(err.what());
+  }
 }
 
 
@@ -56,7 +98,14 @@ ref<Unicode> tp_repr(PyTickTime* self)
   auto const& fmt = self->fmt_;
   std::stringstream ss;
   ss << "TickTime(" << fmt->get_scale() << ", " << fmt->get_precision()
-     << ", \"" << fmt->get_nat() << "\")";
+     << ", \"" << fmt->get_nat() << "\"";
+  if (fmt->get_period() != fixfmt::TickTime::PERIOD_SEC)
+    ss << ", period=" << fmt->get_period();
+  if (fmt->get_tz())
+    ss << ", tz=\"" << fmt->get_tz()->get_name() << "\"";
+  if (fmt->get_pattern() != fixfmt::TickTime::DEFAULT_PATTERN)
+    ss << ", pattern=\"" << fmt->get_pattern() << "\"";
+  ss << ")";
   return Unicode::from(ss.str());
 }
 
@@ -74,6 +123,18 @@ ref<Object> tp_call(PyTickTime* self, Tuple* args, Dict* kw_args)
 auto methods = Methods<PyTickTime>();
 
 
+ref<Object> get_pattern(PyTickTime* const self, void* /* closure */)
+{
+  return Unicode::from(self->fmt_->get_pattern());
+}
+
+
+ref<Object> get_period(PyTickTime* const self, void* /* closure */)
+{
+  return Long::FromLong(self->fmt_->get_period());
+}
+
+
 ref<Object> get_precision(PyTickTime* const self, void* /* closure */)
 {
   return Long::FromLong(self->fmt_->get_precision());
@@ -86,6 +147,13 @@ ref<Object> get_scale(PyTickTime* const self, void* /* closure */)
 }
 
 
+ref<Object> get_tz(PyTickTime* const self, void* /* closure */)
+{
+  auto const& tz = self->fmt_->get_tz();
+  return tz ? (ref<Object>) Unicode::from(tz->get_name()) : none_ref();
+}
+
+
 ref<Object> get_width(PyTickTime* const self, void* /* closure */)
 {
   return Long::FromLong(self->fmt_->get_width());
@@ -99,8 +167,11 @@ ref<Object> get_nat(PyTickTime* const self, void* /* closure */)
 
 
 auto getsets = GetSets<PyTickTime>()
+  .add_get<get_pattern>     ("pattern")
+  .add_get<get_period>      ("period")
   .add_get<get_precision>   ("precision")
   .add_get<get_scale>       ("scale")
+  .add_get<get_tz>          ("tz")
   .add_get<get_width>       ("width")
   .add_get<get_nat>         ("nat")
   ;
@@ -146,7 +217,7 @@ Type PyTickTime::type_ = PyTypeObject{
   (descrgetfunc)        nullptr,                            // tp_descr_get
   (descrsetfunc)        nullptr,                            // tp_descr_set
   (Py_ssize_t)          0,                                  // tp_dictoffset
-  (initproc)            tp_init,                            // tp_init
+  (initproc)            wrap<PyTickTime, tp_init>,          // tp_init
   (allocfunc)           nullptr,                            // tp_alloc
   (newfunc)             PyType_GenericNew,                  // tp_new
   (freefunc)            nullptr,                            // tp_free
@@ -2,10 +2,12 @@
 
 #include "PyBool.hh"
 #include "PyNumber.hh"
+#include "PyStrArena.hh"
 #include "PyString.hh"
 #include "PyTable.hh"
 #include "PyTickTime.hh"
 #include "PyTickDate.hh"
+#include "PyTickDuration.hh"
 #include "py.hh"
 
 using namespace py;
@@ -52,6 +54,9 @@ PyInit__ext(void)
     PyString::type_.Ready();
     module->add(&PyString::type_);
 
+    PyStrArena::type_.Ready();
+    module->add(&PyStrArena::type_);
+
     PyTable::type_.Ready();
     module->add(&PyTable::type_);
 
@@ -61,6 +66,9 @@ PyInit__ext(void)
     PyTickDate::type_.Ready();
     module->add(&PyTickDate::type_);
 
+    PyTickDuration::type_.Ready();
+    module->add(&PyTickDuration::type_);
+
     return module.release();
   }
   catch (Exception) {
@@ -0,0 +1,283 @@
+"""
+Arrow arrays, via the Arrow C Data Interface.
+
+Arrays are imported from any object that implements the Arrow PyCapsule
+interface, such as a `pyarrow.Array`, without depending on pyarrow and
+without copying their data.
+"""
+
+import re
+import numpy as np
+
+from   . import _ext
+
+#-------------------------------------------------------------------------------
+
+# Numpy dtypes of fixed-width primitive Arrow formats.
+PRIMITIVE_DTYPES = {
+    "c"     : "<i1",
+    "C"     : "<u1",
+    "s"     : "<i2",
+    "S"     : "<u2",
+    "i"     : "<i4",
+    "I"     : "<u4",
+    "l"     : "<i8",
+    "L"     : "<u8",
+    "f"     : "<f4",
+    "g"     : "<f8",
+}
+
+# Numpy datetime units of Arrow time units.
+TIME_UNITS = {
+    "s"     : "s",
+    "m"     : "ms",
+    "u"     : "us",
+    "n"     : "ns",
+}
+
+# Arrow variable-length string formats, and the dtypes of their offsets.
+STRING_OFFSET_DTYPES = {
+    "u"     : "<i4",
+    "U"     : "<i8",
+}
+
+def is_arrow(obj):
+    """
+    Returns true if `obj` is an Arrow array or stream, such as a chunked
+    array, and not a numpy array.
+    """
+    return isinstance(obj, (ArrowArray, ArrowChunks)) or (
+        not isinstance(obj, np.ndarray)
+        and (hasattr(obj, "__arrow_c_array__")
+             or hasattr(obj, "__arrow_c_stream__")))
+
+
+def iter_stream(obj):
+    """
+    Generates the arrays of an Arrow stream, as (schema, array) pairs of
+    capsules, as they are produced.
+
+    :param obj:
+      An object that implements `__arrow_c_stream__()`, such as a chunked
+      array or a record batch reader, or the stream capsule it returns.
+    """
+    stream = (
+        obj.__arrow_c_stream__() if hasattr(obj, "__arrow_c_stream__")
+        else obj)
+    while True:
+        capsules = _ext.arrow_stream_next(stream)
+        if capsules is None:
+            break
+        yield capsules
+
+
+def get_columns(obj):
+    """
+    Returns the columns of a record batch, which is an Arrow struct array, as
+    (name, `ArrowArray`) pairs.  Any other array is a single column.
+    """
+    capsules = (
+        obj.__arrow_c_array__() if hasattr(obj, "__arrow_c_array__") else obj)
+    fmt, name, *_ = _ext.arrow_info(tuple(capsules))
+    if fmt == "+s":
+        columns = [ ArrowArray(c) for c in _ext.arrow_children(capsules) ]
+        return [ (c.name, c) for c in columns ]
+    else:
+        return [(name, ArrowArray(capsules))]
+
+
+def _get_tz(tz):
+    """
+    Returns a time zone for an Arrow timestamp's zone, as a zone name or a
+    fixed offset in seconds east of UTC, or none.
+    """
+    if tz == "":
+        return None
+    match = re.fullmatch(r"([+-])(\d\d):?(\d\d)", tz)
+    if match is None:
+        return tz
+    sign, hours, minutes = match.groups()
+    offset = int(hours) * 3600 + int(minutes) * 60
+    return -offset if sign == "-" else offset
+
+
+class _BufferView:
+    """
+    A numpy array interface to an Arrow buffer, which holds on to its owner.
+    """
+
+    def __init__(self, owner, address, dtype, length):
+        self.owner = owner
+        self.__array_interface__ = {
+            "version"   : 3,
+            "shape"     : (length, ),
+            "typestr"   : np.dtype(dtype).str,
+            "data"      : (address, True),
+        }
+
+
+
+class ArrowArray:
+    """
+    An Arrow array, imported without copying.
+
+    :ivar format:
+      The Arrow format string.
+    :ivar dtype:
+      The numpy dtype corresponding to the Arrow type, for choosing
+      formatters; object for strings.
+    :ivar values:
+      The values as a numpy array, without copying, or none for bit-packed
+      booleans and strings.
+    :ivar mask:
+      A boolean array, true for null entries, or none if there are none.
+    :ivar dictionary:
+      For a dictionary array, the `ArrowArray` of the dictionary's values.
+    :ivar tz:
+      For a timestamp array, its time zone, if any.
+    """
+
+    def __init__(self, obj, *, _capsules=None, _info=None):
+        """
+        :param obj:
+          An object that implements the Arrow PyCapsule interface, or the
+          (schema, array) pair of capsules that its `__arrow_c_array__()`
+          returns.
+        """
+        if _capsules is None:
+            _capsules = (
+                obj.__arrow_c_array__() if hasattr(obj, "__arrow_c_array__")
+                else obj)
+            _info = _ext.arrow_info(tuple(_capsules))
+        # Holding the capsules keeps the Arrow data alive.
+        self.capsules = tuple(_capsules)
+        (self.format, self.name, self.length, self.offset, self.null_count,
+         self.__buffers, dictionary) = _info
+
+        self.dictionary = None if dictionary is None else ArrowArray(
+            None, _capsules=self.capsules, _info=dictionary)
+        self.tz = None
+        self.values = None
+        self.max_length = None
+
+        fmt = self.format
+        if self.dictionary is not None:
+            self.dtype = self.dictionary.dtype
+        elif fmt in PRIMITIVE_DTYPES:
+            self.dtype = np.dtype(PRIMITIVE_DTYPES[fmt])
+        elif fmt == "b":
+            self.dtype = np.dtype(bool)
+        elif fmt in STRING_OFFSET_DTYPES:
+            self.dtype = np.dtype(object)
+        elif fmt[: 2] == "ts" and fmt[3 : 4] == ":" and fmt[2] in TIME_UNITS:
+            self.dtype = np.dtype(f"<M8[{TIME_UNITS[fmt[2]]}]")
+            self.tz = _get_tz(fmt[4 :])
+        elif fmt[: 2] == "tD" and len(fmt) == 3 and fmt[2] in TIME_UNITS:
+            self.dtype = np.dtype(f"<m8[{TIME_UNITS[fmt[2]]}]")
+        else:
+            raise TypeError(f"unsupported Arrow format: {fmt}")
+
+        end = self.offset + self.length
+        if self.dictionary is None and self.dtype.kind in "fiuMm":
+            self.values = self.__view(1, self.dtype, end)[self.offset :]
+
+        self.mask = None
+        if self.null_count != 0 and self.__buffers[0] != 0:
+            bits = self.__view(0, "u1", (end + 7) // 8)
+            valid = np.unpackbits(bits, count=end, bitorder="little")
+            self.mask = valid[self.offset :] == 0
+
+        if self.dictionary is None and fmt in STRING_OFFSET_DTYPES:
+            # Offsets have one more entry than the strings.
+            offsets = self.__view(
+                1, STRING_OFFSET_DTYPES[fmt], end + 1)[self.offset :]
+            if self.length == 0:
+                self.max_length = 0
+            else:
+                data = self.__view(2, "u1", offsets[-1])
+                self.max_length = _ext.max_string_length(
+                    offsets, data, mask=self.mask)
+
+
+    def __view(self, index, dtype, length):
+        """
+        Returns a numpy view of the first `length` items of buffer `index`.
+        """
+        address = self.__buffers[index]
+        if length == 0 or address == 0:
+            return np.empty(0, dtype=dtype)
+        else:
+            return np.asarray(_BufferView(self, address, dtype, length))
+
+
+    def __len__(self):
+        return self.length
+
+
+
+class ArrowChunks:
+    """
+    The chunks of an Arrow column, such as a chunked array or a column of a
+    stream, which are rendered in place, without concatenating them.
+
+    Has the attributes of `ArrowArray`, for choosing formatters.  For these,
+    the values and masks of the chunks are concatenated, of only the leading
+    chunks with at least `analysis_rows` rows, if given.
+
+    :ivar chunks:
+      The `ArrowArray` of each chunk.
+    """
+
+    def __init__(self, chunks, *, analysis_rows=None):
+        """
+        :param chunks:
+          Arrow arrays, or an Arrow stream, as for `iter_stream()`.
+        """
+        if is_arrow(chunks) and not isinstance(chunks, ArrowChunks):
+            chunks = iter_stream(chunks)
+        chunks = [ c if isinstance(c, ArrowArray) else ArrowArray(c)
+                   for c in chunks ]
+        if len(chunks) == 0:
+            raise ValueError("no chunks")
+        first = chunks[0]
+        for chunk in chunks[1 :]:
+            if chunk.format != first.format:
+                raise TypeError(
+                    f"chunk format {chunk.format} isn't {first.format}")
+
+        self.chunks     = chunks
+        self.capsules   = [ c.capsules for c in chunks ]
+        self.format     = first.format
+        self.name       = first.name
+        self.dtype      = first.dtype
+        self.tz         = first.tz
+        self.length     = sum( c.length for c in chunks )
+        self.null_count = sum( c.null_count for c in chunks )
+
+        # The chunks to analyze.
+        if analysis_rows is not None:
+            num = 0
+            for i, chunk in enumerate(chunks):
+                num += chunk.length
+                if num >= analysis_rows:
+                    chunks = chunks[: i + 1]
+                    break
+
+        self.dictionary = None if first.dictionary is None else ArrowChunks(
+            [ c.dictionary for c in chunks ])
+        self.values = None if first.values is None else np.concatenate(
+            [ c.values for c in chunks ])
+        self.mask = None if all( c.mask is None for c in chunks ) else (
+            np.concatenate([
+                np.zeros(c.length, dtype=bool) if c.mask is None else c.mask
+                for c in chunks
+            ]))
+        self.max_length = None if first.max_length is None else max(
+            c.max_length for c in chunks )
+
+
+    def __len__(self):
+        return self.length
+
+
+
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Python.h>
+
+#include "fixfmt/arrow.hh"
+#include "py.hh"
+
+//------------------------------------------------------------------------------
+
+/**
+ * An Arrow array exported by a Python object via the Arrow C Data Interface.
+ *
+ * The object either implements the Arrow PyCapsule interface, with an
+ * '__arrow_c_array__()' method, or is the (schema, array) pair of capsules
+ * that method returns.  The capsules own the structs, and release them when
+ * destroyed; the structs are used in place, so hold on to 'capsules' as long
+ * as the array's data is referenced.
+ */
+class ArrowRef
+{
+public:
+
+  ArrowRef(PyObject* const obj)
+  {
+    if (PyObject_HasAttrString(obj, "__arrow_c_array__"))
+      capsules = ((py::Object*) obj)->CallMethodObjArgs("__arrow_c_array__");
+    else
+      capsules = py::ref<py::Object>::of(obj);
+    if (!PyTuple_Check(capsules)
+        || PyTuple_GET_SIZE((PyObject*) capsules) != 2)
+      throw py::TypeError("not an Arrow array or (schema, array) capsules");
+
+    schema = (ArrowSchema const*) get_pointer(0, "arrow_schema");
+    array = (ArrowArray const*) get_pointer(1, "arrow_array");
+    if (schema->release == nullptr || array->release == nullptr)
+      throw py::ValueError("Arrow array already released");
+  }
+
+  // The (schema, array) capsules.
+  py::ref<py::Object> capsules;
+
+  ArrowSchema const* schema;
+  ArrowArray const* array;
+
+private:
+
+  void*
+  get_pointer(
+    Py_ssize_t const index,
+    char const* const name)
+    const
+  {
+    void* const ptr = PyCapsule_GetPointer(
+      PyTuple_GET_ITEM((PyObject*) capsules, index), name);
+    if (ptr == nullptr)
+      throw py::Exception();
+    return ptr;
+  }
+
+};
+
+
@@ -1,12 +1,25 @@
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
 #include <limits>
+#include <map>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "fixfmt/double-conversion/double-conversion.h"
 #include "fixfmt/double-conversion/fast-dtoa.h"
+#include "fixfmt/base.hh"
+#include "fixfmt/filter.hh"
+#include "fixfmt/sort.hh"
+#include "fixfmt/table.hh"
 #include "fixfmt/text.hh"
+#include "fixfmt/time.hh"
+#include "arrow_ref.hh"
+#include "PyStrArena.hh"
 #include "py.hh"
 
 using namespace py;
@@ -19,25 +32,60 @@ using DTSC = fixfmt::double_conversion::DoubleToStringConverter;
 
 namespace {
 
+/*
+ * An optional byte mask, nonzero for entries to skip, such as nulls.
+ */
+class Mask
+{
+public:
+
+  Mask(PyObject* const obj, size_t const length)
+  {
+    if (obj == Py_None)
+      return;
+    buffer_ = std::make_unique<BufferRef>(obj, PyBUF_ND);
+    if ((*buffer_)->ndim != 1 || (*buffer_)->itemsize != 1)
+      throw TypeError("mask not a one-dimensional byte array");
+    if ((size_t) (*buffer_)->shape[0] != length)
+      throw ValueError("mask length doesn't match");
+    mask_ = reinterpret_cast<uint8_t const*>((*buffer_)->buf);
+  }
+
+  explicit operator bool() const { return mask_ != nullptr; }
+
+  bool operator[](size_t const i) const { return mask_[i] != 0; }
+
+private:
+
+  std::unique_ptr<BufferRef> buffer_;
+  uint8_t const* mask_ = nullptr;
+
+};
+
+
 template<typename TYPE> constexpr auto MODE = DTSC::SHORTEST;
 template<> constexpr auto MODE<float> = DTSC::SHORTEST_SINGLE;
 
 template<typename TYPE>
 ref<Object> analyze_float(Module* module, Tuple* args, Dict* kw_args)
 {
-  static char const* arg_names[] = {"buf", "max_precision", nullptr};
+  static char const* arg_names[] = {
+    "buf", "max_precision", "mask", nullptr};
   PyObject* array_obj;
   int max_precision;
+  PyObject* mask_obj = Py_None;
   Arg::ParseTupleAndKeywords(
-    args, kw_args, "Oi", arg_names, &array_obj, &max_precision);
+    args, kw_args, "Oi|$O", arg_names, &array_obj, &max_precision, &mask_obj);
 
-  BufferRef buffer(array_obj, PyBUF_ND);
+  BufferRef buffer(array_obj, PyBUF_STRIDES);
   if (buffer->ndim != 1)
     throw TypeError("not a one-dimensional array");
   if (buffer->itemsize != sizeof(TYPE))
     throw TypeError("wrong itemsize");
   TYPE const* const array = (TYPE const* const) buffer->buf;
   size_t const length = buffer->shape[0];
+  long const stride = buffer.get_stride();
+  Mask const mask(mask_obj, length);
 
   bool has_nan = false;
   bool has_pos_inf = false;
@@ -55,12 +103,11 @@ ref<Object> analyze_float(Module* module, Tuple* args, Dict* kw_args)
   // Note: Weird.  LLVM 6.1.0 on OSX vectorizes this loop only if the precision
   // logic is _present_, with the result that it runs _faster_ than without.
 
-  for (size_t i = 0; i < length; ++i) {
-    TYPE const val = array[i];
+  auto const analyze = [&](TYPE const val) {
     // Flag NaN.
     if (std::isnan(val)) {
       has_nan = true;
-      continue;
+      return;
     }
     // Flag positive and negative infinity.
     if (std::isinf(val)) {
@@ -68,7 +115,7 @@ ref<Object> analyze_float(Module* module, Tuple* args, Dict* kw_args)
         has_pos_inf = true;
       else
         has_neg_inf = true;
-      continue;
+      return;
     }
     // Keep count of non-NaN/infinity values.
     ++num;
@@ -105,7 +152,21 @@ ref<Object> analyze_float(Module* module, Tuple* args, Dict* kw_args)
         }
       }
     }
-  }
+  };
+
+  if (mask)
+    // Skip masked entries.
+    for (size_t i = 0; i < length; ++i) {
+      if (!mask[i])
+        analyze(fixfmt::load_strided<TYPE>(array, stride, i));
+    }
+  else if (stride == (long) sizeof(TYPE))
+    for (size_t i = 0; i < length; ++i)
+      analyze(array[i]);
+  else
+    // Strided, such as a column of a 2-D array.
+    for (size_t i = 0; i < length; ++i)
+      analyze(fixfmt::load_strided<TYPE>(array, stride, i));
 
   // FIXME-PY3: Use a StructSequenceType.
   return (ref<Tuple>) (Tuple::builder
@@ -120,6 +181,740 @@ ref<Object> analyze_float(Module* module, Tuple* args, Dict* kw_args)
 }
 
 
+/*
+ * Analyzes an array of int64 ticks, such as a datetime64 array viewed as
+ * int64, with 'scale' ticks per second.  Returns whether there are NaTs, the
+ * number of other values and their min and max, and the fractional seconds
+ * precision needed to show them exactly, up to 'max_precision'.  Entries set
+ * in the optional byte 'mask' are skipped.
+ */
+ref<Object> analyze_ticks(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {
+    "buf", "scale", "max_precision", "mask", nullptr};
+  PyObject* array_obj;
+  long scale;
+  int max_precision;
+  PyObject* mask_obj = Py_None;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "Oli|$O", arg_names, 
+    &array_obj, &scale, &max_precision, &mask_obj);
+
+  // Number of decimal digits in a tick's fractional seconds.
+  int scale_digits = 0;
+  for (long s = scale; s > 1 && s % 10 == 0; s /= 10)
+    ++scale_digits;
+  if (scale <= 0 || fixfmt::pow10(scale_digits) != scale)
+    throw ValueError("scale not a power of 10");
+  max_precision = std::max(0, std::min(max_precision, scale_digits));
+
+  BufferRef buffer(array_obj, PyBUF_STRIDES);
+  if (buffer->ndim != 1)
+    throw TypeError("not a one-dimensional array");
+  if (buffer->itemsize != sizeof(long))
+    throw TypeError("wrong itemsize");
+  long const* const array = (long const* const) buffer->buf;
+  size_t const length = buffer->shape[0];
+  long const stride = buffer.get_stride();
+  Mask const mask(mask_obj, length);
+
+  bool has_nat = false;
+  size_t num = 0;
+  long min = std::numeric_limits<long>::max();
+  long max = std::numeric_limits<long>::min();
+
+  // Values are multiples of 'divisor' ticks, if shown with 'precision'
+  // digits.
+  int precision = 0;
+  long divisor = scale;
+
+  auto const analyze = [&](long const val) {
+    if (val == fixfmt::TickTime::NAT_VALUE) {
+      has_nat = true;
+      return;
+    }
+    ++num;
+    if (val < min)
+      min = val;
+    if (val > max)
+      max = val;
+
+    if (precision < max_precision && val % divisor != 0) {
+      // Needs more precision.  Count trailing zeros to find how much.
+      int zeros = 0;
+      for (long rem = val; rem % 10 == 0; rem /= 10)
+        ++zeros;
+      precision = std::min(scale_digits - zeros, max_precision);
+      divisor = fixfmt::pow10(scale_digits - precision);
+    }
+  };
+
+  if (mask)
+    // Skip masked entries.
+    for (size_t i = 0; i < length; ++i) {
+      if (!mask[i])
+        analyze(fixfmt::load_strided<long>(array, stride, i));
+    }
+  else if (stride == (long) sizeof(long))
+    for (size_t i = 0; i < length; ++i)
+      analyze(array[i]);
+  else
+    // Strided, such as a field of a record array.
+    for (size_t i = 0; i < length; ++i)
+      analyze(fixfmt::load_strided<long>(array, stride, i));
+
+  // FIXME-PY3: Use a StructSequenceType.
+  return (ref<Tuple>) (Tuple::builder
+    << Bool::from(has_nat)
+    << Long::FromLong(num)
+    << Long::FromLong(min)
+    << Long::FromLong(max)
+    << Long::FromLong(precision)
+  );
+}
+
+
+/*
+ * Returns the max length, in code points, of variable-length UTF-8 strings,
+ * as in an Arrow utf8 or large_utf8 array: entry i is the bytes of 'data'
+ * from 'offsets[i]' to 'offsets[i + 1]'.  'offsets' are int32 or int64.
+ * Entries set in the optional byte 'mask' are skipped.
+ */
+ref<Object> max_string_length(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {"offsets", "data", "mask", nullptr};
+  PyObject* offsets_obj;
+  PyObject* data_obj;
+  PyObject* mask_obj = Py_None;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "OO|$O", arg_names, &offsets_obj, &data_obj, &mask_obj);
+
+  BufferRef offsets(offsets_obj, PyBUF_ND);
+  if (offsets->ndim != 1 || offsets->shape[0] < 1)
+    throw TypeError("not a one-dimensional array of offsets");
+  BufferRef data(data_obj, PyBUF_SIMPLE);
+  size_t const length = offsets->shape[0] - 1;
+  Mask const mask(mask_obj, length);
+
+  auto const get_max = [&](auto const* const offs) {
+    size_t max = 0;
+    for (size_t i = 0; i < length; ++i) {
+      if (mask && mask[i])
+        continue;
+      long const start = offs[i];
+      long const end = offs[i + 1];
+      if (!(0 <= start && start <= end && end <= data->len))
+        throw ValueError("offset out of range");
+      max = std::max(max, fixfmt::string_length(
+        string((char const*) data->buf + start, end - start)));
+    }
+    return max;
+  };
+
+  size_t max;
+  if (offsets->itemsize == sizeof(int32_t))
+    max = get_max((int32_t const*) offsets->buf);
+  else if (offsets->itemsize == sizeof(int64_t))
+    max = get_max((int64_t const*) offsets->buf);
+  else
+    throw TypeError("wrong itemsize");
+  return Long::FromLong(max);
+}
+
+
+/*
+ * Describes an Arrow array, for analysis: its format, name, length, offset,
+ * null count, buffer addresses, and its dictionary, if any, likewise.
+ */
+ref<Object> get_arrow_info(ArrowSchema const& schema, ArrowArray const& array)
+{
+  auto buffers = Tuple::New(array.n_buffers);
+  for (long i = 0; i < array.n_buffers; ++i)
+    buffers->initialize(i, Long::FromLong((long) array.buffers[i]));
+
+  ref<Object> name = none_ref();
+  if (schema.name != nullptr)
+    name = Unicode::from(schema.name);
+  ref<Object> dictionary = none_ref();
+  if (schema.dictionary != nullptr && array.dictionary != nullptr)
+    dictionary = get_arrow_info(*schema.dictionary, *array.dictionary);
+
+  // FIXME-PY3: Use a StructSequenceType.
+  return (ref<Tuple>) (Tuple::builder
+    << Unicode::from(schema.format)
+    << std::move(name)
+    << Long::FromLong(array.length)
+    << Long::FromLong(array.offset)
+    << Long::FromLong(array.null_count)
+    << std::move(buffers)
+    << std::move(dictionary)
+  );
+}
+
+
+/*
+ * Describes an Arrow array given as a (schema, array) pair of capsules.  The
+ * buffer addresses are valid while the capsules are.
+ */
+ref<Object> arrow_info(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {"capsules", nullptr};
+  PyObject* capsules;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "O!", arg_names, &PyTuple_Type, &capsules);
+
+  ArrowRef const arrow(capsules);
+  return get_arrow_info(*arrow.schema, *arrow.array);
+}
+
+
+/*
+ * Releases and frees an Arrow struct we own, when its capsule is destroyed.
+ */
+template<typename STRUCT>
+void release_arrow_capsule(PyObject* const capsule)
+{
+  auto const ptr = (STRUCT*) PyCapsule_GetPointer(
+    capsule, PyCapsule_GetName(capsule));
+  if (ptr != nullptr && ptr->release != nullptr)
+    ptr->release(ptr);
+  delete ptr;
+}
+
+
+/*
+ * Releases the parent capsules that a child's capsule holds on to.
+ */
+void release_arrow_child_capsule(PyObject* const capsule)
+{
+  Py_XDECREF((PyObject*) PyCapsule_GetContext(capsule));
+}
+
+
+/*
+ * Returns the next array from an Arrow stream, given as an
+ * "arrow_array_stream" capsule, as a (schema, array) pair of capsules, or
+ * none at the end of the stream.  The capsules own the structs.
+ */
+ref<Object> arrow_stream_next(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {"stream", nullptr};
+  PyObject* capsule;
+  Arg::ParseTupleAndKeywords(args, kw_args, "O", arg_names, &capsule);
+
+  auto const stream = (ArrowArrayStream*) PyCapsule_GetPointer(
+    capsule, "arrow_array_stream");
+  if (stream == nullptr)
+    throw Exception();
+  if (stream->release == nullptr)
+    throw ValueError("Arrow stream already released");
+
+  auto const error = [stream](int const err) {
+    char const* const msg = stream->get_last_error(stream);
+    throw RuntimeError(
+      msg == nullptr ? "Arrow stream error " + std::to_string(err) : msg);
+  };
+
+  // Allocate the structs, and give them to capsules immediately, which free
+  // them even if we fail.
+  auto const schema = new ArrowSchema{};
+  auto schema_capsule = ref<Object>::take(check_not_null(PyCapsule_New(
+    schema, "arrow_schema", release_arrow_capsule<ArrowSchema>)));
+  auto const array = new ArrowArray{};
+  auto array_capsule = ref<Object>::take(check_not_null(PyCapsule_New(
+    array, "arrow_array", release_arrow_capsule<ArrowArray>)));
+
+  int err = stream->get_schema(stream, schema);
+  if (err != 0)
+    error(err);
+  err = stream->get_next(stream, array);
+  if (err != 0)
+    error(err);
+  if (array->release == nullptr)
+    // End of stream.
+    return none_ref();
+
+  return (ref<Tuple>) (Tuple::builder
+    << std::move(schema_capsule)
+    << std::move(array_capsule)
+  );
+}
+
+
+/*
+ * Returns the children of an Arrow struct array, such as the columns of a
+ * record batch, given as a (schema, array) pair of capsules, as pairs of
+ * capsules.  These hold on to the parent's capsules, which own the data.
+ */
+ref<Object> arrow_children(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {"capsules", nullptr};
+  PyObject* capsules;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "O!", arg_names, &PyTuple_Type, &capsules);
+
+  ArrowRef const arrow(capsules);
+  auto const& schema = *arrow.schema;
+  auto const& array = *arrow.array;
+  if (schema.n_children != array.n_children)
+    throw ValueError("Arrow schema and array children don't match");
+  if (array.n_children > 0 && array.offset != 0)
+    throw ValueError("Arrow struct array with offset not supported");
+
+  auto const child_capsule = [&](void* const ptr, char const* const name) {
+    auto capsule = ref<Object>::take(check_not_null(
+      PyCapsule_New(ptr, name, release_arrow_child_capsule)));
+    Py_INCREF(capsules);
+    if (PyCapsule_SetContext(capsule, capsules) != 0) {
+      Py_DECREF(capsules);
+      throw Exception();
+    }
+    return capsule;
+  };
+
+  auto children = Tuple::New(array.n_children);
+  for (long i = 0; i < array.n_children; ++i)
+    children->initialize(i, (ref<Tuple>) (Tuple::builder
+      << child_capsule(schema.children[i], "arrow_schema")
+      << child_capsule(array.children[i], "arrow_array")));
+  return std::move(children);
+}
+
+
+/*
+ * Calls 'fn' with the values of a one-dimensional buffer of numbers or
+ * booleans, as a pointer of their type, and returns its result.
+ */
+template<typename FN>
+auto
+with_numbers(
+  BufferRef& buffer,
+  FN const& fn)
+  -> decltype(fn((uint8_t const*) nullptr))
+{
+  void const* const buf = buffer->buf;
+  // The last character of a struct format is the type code.
+  char const* const format = buffer->format == nullptr ? "B" : buffer->format;
+  char const code = format[strlen(format) - 1];
+  switch (code) {
+  case 'b': case 'h': case 'i': case 'l': case 'q':
+    switch (buffer->itemsize) {
+    case 1: return fn((int8_t const*) buf);
+    case 2: return fn((int16_t const*) buf);
+    case 4: return fn((int32_t const*) buf);
+    case 8: return fn((int64_t const*) buf);
+    }
+    break;
+
+  case '?': case 'B': case 'H': case 'I': case 'L': case 'Q':
+    switch (buffer->itemsize) {
+    case 1: return fn((uint8_t const*) buf);
+    case 2: return fn((uint16_t const*) buf);
+    case 4: return fn((uint32_t const*) buf);
+    case 8: return fn((uint64_t const*) buf);
+    }
+    break;
+
+  case 'f':
+    return fn((float const*) buf);
+
+  case 'd':
+    return fn((double const*) buf);
+  }
+  throw TypeError(string("unsupported array type ") + format);
+}
+
+
+/*
+ * The element type of a pointer to numbers, as passed by `with_numbers()`.
+ */
+template<typename PTR>
+using Elem = std::remove_const_t<std::remove_pointer_t<PTR>>;
+
+
+/*
+ * Returns a sort key for a one-dimensional array of numbers or booleans.
+ */
+std::unique_ptr<fixfmt::SortKey>
+make_sort_key(
+  BufferRef& buffer,
+  bool const descending)
+{
+  return with_numbers(buffer, [&](auto const* const values) {
+    using TYPE = Elem<decltype(values)>;
+    return std::unique_ptr<fixfmt::SortKey>(new fixfmt::ArraySortKey<TYPE>(
+      values, descending, buffer.get_stride()));
+  });
+}
+
+
+/*
+ * Orders rows by one-dimensional arrays 'keys', the first key first, and
+ * stores the row indices in that order in int64 array 'out'.  'descending' is
+ * a bool for each key.  If 'out' is shorter than the keys, stores only the
+ * leading rows, as for the top N, which is faster than a full sort.
+ */
+ref<Object> argsort(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {"keys", "out", "descending", nullptr};
+  PyObject* keys_arg;
+  PyObject* out_arg;
+  PyObject* descending_arg;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "O!OO!", arg_names,
+    &PyTuple_Type, &keys_arg, &out_arg, &PyTuple_Type, &descending_arg);
+
+  auto const num_keys = PyTuple_GET_SIZE(keys_arg);
+  if (num_keys == 0)
+    throw ValueError("no keys");
+  if (PyTuple_GET_SIZE(descending_arg) != num_keys)
+    throw ValueError("descending length doesn't match keys");
+
+  std::vector<BufferRef> buffers;
+  std::vector<std::unique_ptr<fixfmt::SortKey>> keys;
+  long length = -1;
+  for (Py_ssize_t i = 0; i < num_keys; ++i) {
+    buffers.emplace_back(
+      PyTuple_GET_ITEM(keys_arg, i), PyBUF_STRIDES | PyBUF_FORMAT);
+    auto& buffer = buffers.back();
+    if (buffer->ndim != 1)
+      throw TypeError("key not a one-dimensional array");
+    if (length == -1)
+      length = buffer->shape[0];
+    else if (buffer->shape[0] != length)
+      throw ValueError("key lengths don't match");
+    int const descending = PyObject_IsTrue(
+      PyTuple_GET_ITEM(descending_arg, i));
+    if (descending == -1)
+      throw Exception();
+    keys.push_back(make_sort_key(buffer, descending));
+  }
+
+  BufferRef out(out_arg, PyBUF_ND | PyBUF_WRITABLE);
+  if (out->ndim != 1 || out->itemsize != sizeof(long))
+    throw TypeError("out not a one-dimensional int64 array");
+  long const num = out->shape[0];
+  if (num > length)
+    throw ValueError("out longer than keys");
+
+  {
+    ReleaseGIL release;
+    fixfmt::argsort(keys, length, (long*) out->buf, num);
+  }
+  return none_ref();
+}
+
+
+//------------------------------------------------------------------------------
+// Row filters
+
+/*
+ * Buffers and objects that predicates reference, to hold while they are
+ * evaluated.
+ */
+struct FilterRefs
+{
+  std::vector<BufferRef> buffers;
+  std::vector<ref<Object>> objects;
+
+  /*
+   * Returns a one-dimensional buffer of 'obj', which must have 'length'
+   * entries.
+   */
+  BufferRef&
+  get_buffer(
+    PyObject* const obj,
+    long const length)
+  {
+    buffers.emplace_back(obj, PyBUF_STRIDES | PyBUF_FORMAT);
+    auto& buffer = buffers.back();
+    if (buffer->ndim != 1)
+      throw TypeError("not a one-dimensional array");
+    if (buffer->shape[0] != length)
+      throw ValueError("array length doesn't match");
+    return buffer;
+  }
+};
+
+
+/*
+ * Returns a value to which to compare, as a long, unsigned long, or double.
+ */
+template<typename VALUE>
+VALUE
+get_value(
+  PyObject* const obj)
+{
+  auto const val
+    = std::is_floating_point<VALUE>::value ? (VALUE) PyFloat_AsDouble(obj)
+    : std::is_unsigned<VALUE>::value ? (VALUE) PyLong_AsUnsignedLong(obj)
+    : (VALUE) PyLong_AsLong(obj);
+  if (val == (VALUE) -1 && PyErr_Occurred())
+    throw Exception();
+  return val;
+}
+
+
+/*
+ * Returns a predicate that compares values of 'buffer' to 'value', or to
+ * the range 'value' through 'hi', if 'hi' is not null.  Compares as doubles
+ * if the values or 'value' are floating point, as unsigned longs if the
+ * values are uint64, otherwise as longs.
+ */
+template<typename TYPE>
+std::unique_ptr<fixfmt::Predicate>
+make_compare_predicate(
+  TYPE const* const values,
+  long const stride,
+  fixfmt::CompareOp const op,
+  PyObject* const value,
+  PyObject* const hi=nullptr)
+{
+  auto const make = [&](auto const zero) {
+    using VALUE = decltype(zero);
+    if (hi == nullptr)
+      return std::unique_ptr<fixfmt::Predicate>(
+        new fixfmt::ComparePredicate<TYPE, VALUE>(
+          values, op, get_value<VALUE>(value), stride));
+    else
+      return std::unique_ptr<fixfmt::Predicate>(
+        new fixfmt::RangePredicate<TYPE, VALUE>(
+          values, get_value<VALUE>(value), get_value<VALUE>(hi), stride));
+  };
+  if (std::is_floating_point<TYPE>::value
+      || PyFloat_Check(value) || (hi != nullptr && PyFloat_Check(hi)))
+    return make(0.0);
+  else if (std::is_same<TYPE, uint64_t>::value)
+    return make(0UL);
+  else
+    return make(0L);
+}
+
+
+/*
+ * Returns a string predicate for 'strs', a `StrArena` or an Arrow UTF-8
+ * array as a (schema, array) pair of capsules.
+ */
+std::unique_ptr<fixfmt::Predicate>
+make_string_predicate(
+  PyObject* const strs,
+  fixfmt::StringOp const op,
+  string pattern,
+  long const length,
+  FilterRefs& refs)
+{
+  using fixfmt::StringPredicate;
+
+  if (PyObject_TypeCheck(strs, &PyStrArena::type_)) {
+    refs.objects.push_back(ref<Object>::of(strs));
+    auto const& arena = *(PyStrArena const*) strs;
+    if (arena.get_length() != length)
+      throw ValueError("array length doesn't match");
+    if (arena.is_interned())
+      // Match each distinct string once.
+      return std::make_unique<StringPredicate<size_t>>(
+        arena.offsets_.data(), arena.data_.data(), op, std::move(pattern),
+        arena.codes_.data(), arena.get_num_entries());
+    else
+      return std::make_unique<StringPredicate<size_t>>(
+        arena.offsets_.data(), arena.data_.data(), op, std::move(pattern));
+  }
+
+  ArrowRef arrow(strs);
+  auto const& array = *arrow.array;
+  if (array.length != length)
+    throw ValueError("array length doesn't match");
+  // Hold on to the capsules, which own the data.
+  refs.objects.push_back(std::move(arrow.capsules));
+  string const format = arrow.schema->format;
+  if (format == "u")
+    return std::make_unique<StringPredicate<int32_t>>(
+      fixfmt::get_arrow_buffer<int32_t>(array, 1) + array.offset,
+      fixfmt::get_arrow_buffer<char>(array, 2), op, std::move(pattern));
+  else if (format == "U")
+    return std::make_unique<StringPredicate<int64_t>>(
+      fixfmt::get_arrow_buffer<int64_t>(array, 1) + array.offset,
+      fixfmt::get_arrow_buffer<char>(array, 2), op, std::move(pattern));
+  else
+    throw TypeError("not an Arrow string array: " + format);
+}
+
+
+/*
+ * Builds a predicate from 'spec', a tuple of an operation and its
+ * arguments.  See `filter_rows()`.
+ */
+std::unique_ptr<fixfmt::Predicate>
+make_predicate(
+  PyObject* const spec,
+  long const length,
+  FilterRefs& refs)
+{
+  if (!PyTuple_Check(spec) || PyTuple_GET_SIZE(spec) < 1)
+    throw TypeError("filter spec not a tuple");
+  auto const num_args = PyTuple_GET_SIZE(spec) - 1;
+  auto const arg = [spec](Py_ssize_t const i) {
+    return PyTuple_GET_ITEM(spec, i + 1);
+  };
+  auto const check_args = [num_args](Py_ssize_t const num) {
+    if (num_args != num)
+      throw TypeError("wrong number of filter spec args");
+  };
+  auto const name = ((Object*) PyTuple_GET_ITEM(spec, 0))->Str()
+    ->as_utf8_string();
+
+  if (name == "all" || name == "any") {
+    std::vector<std::unique_ptr<fixfmt::Predicate>> preds;
+    for (Py_ssize_t i = 0; i < num_args; ++i)
+      preds.push_back(make_predicate(arg(i), length, refs));
+    return std::make_unique<fixfmt::AllAnyPredicate>(
+      name == "all", std::move(preds));
+  }
+
+  else if (name == "not") {
+    check_args(1);
+    return std::make_unique<fixfmt::NotPredicate>(
+      make_predicate(arg(0), length, refs));
+  }
+
+  else if (name == "mask") {
+    check_args(1);
+    auto& buffer = refs.get_buffer(arg(0), length);
+    if (buffer->itemsize != 1 || buffer.get_stride() != 1)
+      throw TypeError("mask not a contiguous byte array");
+    return std::make_unique<fixfmt::MaskPredicate>(
+      (uint8_t const*) buffer->buf);
+  }
+
+  else if (name == "cmp") {
+    check_args(3);
+    static std::map<string, fixfmt::CompareOp> const ops = {
+      {"==", fixfmt::CompareOp::EQ},
+      {"!=", fixfmt::CompareOp::NE},
+      {"<" , fixfmt::CompareOp::LT},
+      {"<=", fixfmt::CompareOp::LE},
+      {">" , fixfmt::CompareOp::GT},
+      {">=", fixfmt::CompareOp::GE},
+    };
+    auto const op = ops.find(((Object*) arg(0))->Str()->as_utf8_string());
+    if (op == ops.end())
+      throw ValueError("unknown comparison");
+    auto& buffer = refs.get_buffer(arg(1), length);
+    return with_numbers(buffer, [&](auto const* const values) {
+      return make_compare_predicate(
+        values, buffer.get_stride(), op->second, arg(2));
+    });
+  }
+
+  else if (name == "between") {
+    check_args(3);
+    auto& buffer = refs.get_buffer(arg(0), length);
+    return with_numbers(buffer, [&](auto const* const values) {
+      return make_compare_predicate(
+        values, buffer.get_stride(), fixfmt::CompareOp::EQ, arg(1), arg(2));
+    });
+  }
+
+  else if (name == "isnan") {
+    check_args(1);
+    auto& buffer = refs.get_buffer(arg(0), length);
+    long const stride = buffer.get_stride();
+    return with_numbers(buffer, [&](auto const* const values) {
+      using TYPE = Elem<decltype(values)>;
+      return std::unique_ptr<fixfmt::Predicate>(
+        new fixfmt::NanPredicate<TYPE>(values, stride));
+    });
+  }
+
+  else if (name == "str") {
+    check_args(3);
+    static std::map<string, fixfmt::StringOp> const ops = {
+      {"=="         , fixfmt::StringOp::EQ},
+      {"startswith" , fixfmt::StringOp::STARTSWITH},
+      {"endswith"   , fixfmt::StringOp::ENDSWITH},
+      {"contains"   , fixfmt::StringOp::CONTAINS},
+    };
+    auto const op = ops.find(((Object*) arg(0))->Str()->as_utf8_string());
+    if (op == ops.end())
+      throw ValueError("unknown string operation");
+    return make_string_predicate(
+      arg(1), op->second, ((Object*) arg(2))->Str()->as_utf8_string(), length,
+      refs);
+  }
+
+  else
+    throw ValueError("unknown filter: " + name);
+}
+
+
+/*
+ * Returns the rows, of 'length', that match a predicate, as the bytes of an
+ * int64 array of row indices.
+ *
+ * 'spec' is a tuple of an operation and its arguments, one of,
+ *
+ *   ("all", spec, ...) or ("any", spec, ...)
+ *   ("not", spec)
+ *   ("mask", bool_array)
+ *   ("cmp", op, array, value), for op "==", "!=", "<", "<=", ">", ">="
+ *   ("between", array, lo, hi), inclusive
+ *   ("isnan", float_array)
+ *   ("str", op, strs, pattern), for op "==", "startswith", "endswith",
+ *       "contains", and strs a `StrArena` or Arrow UTF-8 array capsules
+ *
+ * Arrays are numbers or booleans.  The predicate is evaluated a block of rows
+ * at a time, without the GIL.
+ */
+ref<Object> filter_rows(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {"spec", "length", nullptr};
+  PyObject* spec;
+  long length;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "Ol", arg_names, &spec, &length);
+  if (length < 0)
+    throw ValueError("negative length");
+
+  FilterRefs refs;
+  auto const pred = make_predicate(spec, length, refs);
+  std::vector<long> rows;
+  {
+    ReleaseGIL release;
+    fixfmt::filter_rows(*pred, 0, length, rows);
+  }
+  return ref<Object>::take(check_not_null(PyBytes_FromStringAndSize(
+    (char const*) rows.data(), rows.size() * sizeof(long))));
+}
+
+
+//------------------------------------------------------------------------------
+
+/*
+ * Returns the rows of 'length' to show in at most 'max_lines' lines, as a
+ * tuple of the numbers of leading and trailing rows.  If these are fewer
+ * than all rows, the rows between are elided, with an ellipsis line instead.
+ */
+ref<Object> get_visible(Module* module, Tuple* args, Dict* kw_args)
+{
+  static char const* arg_names[] = {
+    "length", "max_lines", "position", nullptr};
+  long length;
+  long max_lines;
+  double position;
+  Arg::ParseTupleAndKeywords(
+    args, kw_args, "lld", arg_names, &length, &max_lines, &position);
+  if (length < 0)
+    throw ValueError("negative length");
+
+  auto const visible
+    = fixfmt::Table::get_visible(length, max_lines, position);
+  return (ref<Tuple>) (Tuple::builder
+    << Long::FromLong(visible.num_top)
+    << Long::FromLong(visible.num_bottom)
+  );
+}
+
+
 ref<Object> center(Module* module, Tuple* args, Dict* kw_args)
 {
   static char const* arg_names[] = {
@@ -255,8 +1050,16 @@ Methods<Module>& add_functions(Methods<Module>& methods)
   methods
     .add<analyze_float<double>> ("analyze_double")
     .add<analyze_float<float>>  ("analyze_float")
+    .add<analyze_ticks>         ("analyze_ticks")
+    .add<argsort>               ("argsort")
+    .add<arrow_children>        ("arrow_children")
+    .add<arrow_info>            ("arrow_info")
+    .add<arrow_stream_next>     ("arrow_stream_next")
     .add<center>                ("center")
     .add<elide>                 ("elide")
+    .add<filter_rows>           ("filter_rows")
+    .add<get_visible>           ("get_visible")
+    .add<max_string_length>     ("max_string_length")
     .add<pad>                   ("pad")
     .add<palide>                ("palide")
     .add<string_length>         ("string_length")
@@ -6,10 +6,11 @@ Formatting for numpy arrays.
 
 from   math import floor, log10
 import numpy as np
-import re
 
-from   ._ext import Bool, Number, String, TickTime, TickDate
+from   ._ext import Bool, Number, String, StrArena, TickTime, TickDate
+from   ._ext import TickDuration
 from   ._ext import string_length, analyze_double, analyze_float
+from   ._ext import analyze_ticks
 
 #-------------------------------------------------------------------------------
 
@@ -49,6 +50,13 @@ DEFAULT_CFG = {
         "min_width"     : 0,
         "max_precision" : None,
         "min_precision" : None,
+        "pattern"       : None,
+    },
+    "duration": {
+        "min_width"     : 0,
+        "max_precision" : None,
+        "min_precision" : None,
+        "style"         : "clock",
     },
 }
 
@@ -62,7 +70,8 @@ def num_digits(value):
     )
 
 
-def choose_formatter_bool(arr, min_width=0, cfg=DEFAULT_CFG["bool"]):
+def choose_formatter_bool(
+        arr, min_width=0, cfg=DEFAULT_CFG["bool"], mask=None):
     min_width   = max(min_width, cfg["min_width"])
     true        = cfg["true"]
     false       = cfg["false"]
@@ -74,7 +83,14 @@ def choose_formatter_bool(arr, min_width=0, cfg=DEFAULT_CFG["bool"]):
     return Bool(true, false, size=size)
 
 
-def choose_formatter_number(arr, min_width=0, cfg=DEFAULT_CFG["number"]):
+def choose_formatter_number(
+        arr, min_width=0, cfg=DEFAULT_CFG["number"], mask=None):
+    """
+    Chooses a formatter for a numerical array.
+
+    :param mask:
+      A boolean array, true for null entries, which are not analyzed.
+    """
     min_width   = max(min_width, cfg["min_width"])
 
     # Analyze the array to determine relevant properties.
@@ -84,20 +100,18 @@ def choose_formatter_number(arr, min_width=0, cfg=DEFAULT_CFG["number"]):
         arr /= scale_factor
 
     if arr.dtype.kind == "f":
-        # analyze_*() require arguments to support the buffer C API;
-        # noncontiguous arrays do not seem to.  FIXME: Not sure why not.
-        arr = np.ascontiguousarray(arr)
         max_precision = cfg["max_precision"]
         if max_precision is None:
             max_precision = 16 if arr.dtype.itemsize == 8 else 8
         analyze = analyze_double if arr.dtype.itemsize == 8 else analyze_float
         (has_nan, has_pos_inf, has_neg_inf, num_vals, min_val, max_val, 
-            val_prec) = analyze(arr, max_precision)
+            val_prec) = analyze(arr, max_precision, mask=mask)
     elif arr.dtype.kind in "iu":
         has_nan = has_pos_inf = has_neg_inf = False
-        num_vals = len(arr)
-        min_val = arr.min()
-        max_val = arr.max()
+        vals = arr if mask is None else arr[~mask]
+        num_vals = len(vals)
+        min_val = vals.min() if num_vals > 0 else 0
+        max_val = vals.max() if num_vals > 0 else 0
         val_prec = 0
     else:
         raise TypeError("not a number dtype: {}".format(arr.dtype))
@@ -148,56 +162,165 @@ def choose_formatter_number(arr, min_width=0, cfg=DEFAULT_CFG["number"]):
     return fmt
 
 
-def choose_formatter_datetime64(values, min_width=0, cfg=DEFAULT_CFG["time"]):
-    min_width   = max(min_width, cfg["min_width"])
+# Decimal exponents of datetime64 tick scales, and periods in seconds of
+# ticks coarser than seconds.
+DATETIME64_SCALES = {
+    "s"     : 0,
+    "ms"    : 3,
+    "us"    : 6,
+    "ns"    : 9,
+    "ps"    : 12,
+    "fs"    : 15,
+    "as"    : 18,
+}
+
+DATETIME64_PERIODS = {
+    "m"     : 60,
+    "h"     : 3600,
+}
+
+DATETIME64_DATE_UNITS = {"D", "W", "M", "Y"}
 
-    # FIXME: Is this really the right way to extract the datetime64 tick scale??
-    match = re.match(r"datetime64\[(.*)\]$", values.dtype.name)
-    assert match is not None
-    scale = match.group(1)
-    if scale == "D":
-        return TickDate()
+def choose_formatter_datetime64(
+        values, min_width=0, cfg=DEFAULT_CFG["time"], tz=None, mask=None):
+    """
+    Chooses a formatter for a datetime64 array.
+
+    :param tz:
+      The time zone in which to show times, as a zone name or a fixed offset
+      in seconds east of UTC; UTC if none.  Values are always UTC.
+    :param mask:
+      A boolean array, true for null entries, which are not analyzed.
+    """
+    min_width   = max(min_width, cfg["min_width"])
+    # The layout, if other than the default ISO 8601 with UTC offset.
+    kw_args     = {} if cfg["pattern"] is None else {"pattern": cfg["pattern"]}
+
+    unit, count = np.datetime_data(values.dtype)
+    if count != 1:
+        raise TypeError(f"no default formatter for datetime64 unit {count}{unit}")
+    # Ticks, without copying, even if strided.
+    ticks = values.view("int64")
+
+    if unit in DATETIME64_DATE_UNITS:
+        # Render the dates in the column's range up front.
+        _, num, min_val, max_val, _ = analyze_ticks(ticks, 1, 0, mask=mask)
+        if num == 0:
+            return TickDate(unit=unit)
+        return TickDate(min_val, max_val, unit=unit)
+    if unit in DATETIME64_PERIODS:
+        return TickTime(period=DATETIME64_PERIODS[unit], tz=tz, **kw_args)
     try:
-        scale = {
-            "s"     : 0,
-            "ms"    : 3,
-            "us"    : 6,
-            "ns"    : 9,
-        }[scale]
+        scale = DATETIME64_SCALES[unit]
     except KeyError:
-        raise TypeError(f"no default formatter for datetime64 scale {scale}")
+        raise TypeError(f"no default formatter for datetime64 unit {unit}")
 
-    # FIXME: Accelerate this with an extension module.
-    values = values.astype("int64")
     max_prec = cfg["max_precision"]
-    max_prec = min(scale, 9 if max_prec is None else max_prec)
+    max_prec = scale if max_prec is None else min(scale, max_prec)
     min_prec = cfg["min_precision"]
     min_prec = 0 if min_prec is None else min_prec
-    for precision in range(max_prec, min_prec, -1):
-        if not (values % (10 ** (scale - precision + 1)) == 0).all():
-            break
+    _, _, _, _, precision = analyze_ticks(
+        ticks, 10 ** scale, max_prec, mask=mask)
+    precision = max(precision, min_prec)
+
+    precision = -1 if precision < 1 else precision
+    return TickTime(10 ** scale, precision, tz=tz, **kw_args)
+
+
+# Periods in seconds of timedelta64 ticks coarser than seconds.  Months and
+# years have no fixed length.
+TIMEDELTA64_PERIODS = {
+    "m"     : 60,
+    "h"     : 3600,
+    "D"     : 86400,
+    "W"     : 604800,
+}
+
+def choose_formatter_timedelta64(
+        values, min_width=0, cfg=DEFAULT_CFG["duration"], mask=None):
+    """
+    Chooses a formatter for a timedelta64 array.
+
+    :param mask:
+      A boolean array, true for null entries, which are not analyzed.
+    """
+    min_width   = max(min_width, cfg["min_width"])
+
+    unit, count = np.datetime_data(values.dtype)
+    if count != 1:
+        raise TypeError(f"no default formatter for timedelta64 unit {count}{unit}")
+    # Ticks, without copying, even if strided.
+    ticks = values.view("int64")
+
+    if unit in TIMEDELTA64_PERIODS:
+        scale, period = 0, TIMEDELTA64_PERIODS[unit]
     else:
-        precision = min_prec
+        try:
+            scale, period = DATETIME64_SCALES[unit], 1
+        except KeyError:
+            raise TypeError(f"no default formatter for timedelta64 unit {unit}")
 
+    max_prec = cfg["max_precision"]
+    max_prec = scale if max_prec is None else min(scale, max_prec)
+    min_prec = cfg["min_precision"]
+    min_prec = 0 if min_prec is None else min_prec
+    _, num, min_val, max_val, precision = analyze_ticks(
+        ticks, 10 ** scale, max_prec, mask=mask)
+    precision = max(precision, min_prec)
     precision = -1 if precision < 1 else precision
-    return TickTime(10 ** scale, precision)
+
+    # Enough day digits for the largest magnitude.
+    days = 0 if num == 0 else max(abs(min_val), abs(max_val))
+    days = days * period // (86400 * 10 ** scale)
+    day_digits = len(str(days))
+
+    kw_args = dict(
+        scale=10 ** scale, precision=precision, style=cfg["style"],
+        day_digits=day_digits, period=period)
+    fmt = TickDuration(**kw_args)
+    if fmt.width < min_width:
+        # Widen the days to achieve minimum width.
+        kw_args["day_digits"] = min(day_digits + min_width - fmt.width, 18)
+        fmt = TickDuration(**kw_args)
+    return fmt
+
+
+def _has_max_length(arr):
+    """
+    Returns true if `arr` is a collection of strings of known max length.
+    """
+    return (
+        isinstance(arr, StrArena)
+        or getattr(arr, "max_length", None) is not None)
 
 
 def choose_formatter_str(arr, min_width=0, cfg=DEFAULT_CFG["string"]):
+    """
+    Chooses a string formatter.
+
+    :param arr:
+      An array of strings or objects, or a `StrArena` of the strings of an
+      object array, or another collection of strings with a `max_length`,
+      such as an Arrow string array.
+    """
     min_width = max(min_width, cfg["min_width"])
 
     size = cfg["size"]
     if size is None:
         min_size = cfg["min_size"]
         max_size = cfg["max_size"]
-        if arr.dtype.kind == "O":
-            size = lambda x: string_length(str(x))
-        elif arr.dtype.kind == "S":
-            # FIXME: For now we assume default-encoded strings.
-            size = lambda x: string_length(x.decode())
-        elif arr.dtype.kind == "U":
-            size = string_length
-        size = np.vectorize(size)(arr).max() if len(arr) > 0 else 0
+        if _has_max_length(arr):
+            size = arr.max_length
+        elif arr.dtype.kind == "O":
+            # Convert each object with str() once, natively.
+            size = StrArena(arr).max_length
+        else:
+            if arr.dtype.kind == "S":
+                # FIXME: For now we assume default-encoded strings.
+                size = lambda x: string_length(x.decode())
+            elif arr.dtype.kind == "U":
+                size = string_length
+            size = np.vectorize(size)(arr).max() if len(arr) > 0 else 0
         size = max(min_width, min_size, min(size, max_size))
 
     return String(
@@ -205,16 +328,34 @@ def choose_formatter_str(arr, min_width=0, cfg=DEFAULT_CFG["string"]):
         elide_pos=cfg["elide_pos"], pad_pos=cfg["pad_pos"])
 
 
-def choose_formatter(arr, min_width=0, cfg=DEFAULT_CFG):
+def choose_formatter(arr, min_width=0, cfg=DEFAULT_CFG, *, tz=None, mask=None):
+    """
+    Chooses a formatter for an array.
+
+    :param mask:
+      A boolean array, true for null entries, which are not analyzed; none if
+      all entries are valid.
+    """
     min_width = max(min_width, cfg["min_width"])
+    if mask is not None:
+        mask = np.ascontiguousarray(mask, dtype=bool)
+
+    if _has_max_length(arr):
+        return choose_formatter_str(arr, min_width, cfg=cfg["string"])
 
     dtype = arr.dtype
     if dtype.kind == "b":
-        return choose_formatter_bool(arr, min_width, cfg=cfg["bool"])
+        return choose_formatter_bool(
+            arr, min_width, cfg=cfg["bool"], mask=mask)
     elif dtype.kind in "fiu":
-        return choose_formatter_number(arr, min_width, cfg=cfg["number"])
+        return choose_formatter_number(
+            arr, min_width, cfg=cfg["number"], mask=mask)
     elif dtype.kind == "M":
-        return choose_formatter_datetime64(arr, min_width, cfg=cfg["time"])
+        return choose_formatter_datetime64(
+            arr, min_width, cfg=cfg["time"], tz=tz, mask=mask)
+    elif dtype.kind == "m":
+        return choose_formatter_timedelta64(
+            arr, min_width, cfg=cfg["duration"], mask=mask)
     elif dtype.kind in "OSU":
         return choose_formatter_str(arr, min_width, cfg=cfg["string"])
     else:
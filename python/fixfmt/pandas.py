@@ -1,3 +1,4 @@
+import numpy as np
 import pandas as pd
 
 from   . import table
@@ -5,31 +6,86 @@ from   .lib import container
 
 #-------------------------------------------------------------------------------
 
+def _get_array(values):
+    """
+    Returns a numpy array for index or series values.
+    """
+    # Extension arrays, e.g. for the string dtype, don't support the buffer
+    # protocol.
+    return values if isinstance(values, np.ndarray) else np.asarray(values)
+
+
+def _get_masked(values):
+    """
+    For a masked extension array, such as for the nullable "Int64", "Float64",
+    or "boolean" dtypes, returns its values and null mask, without copying;
+    otherwise none.
+    """
+    # Masked arrays keep their values and mask in private attributes.
+    data = getattr(values, "_data", None)
+    mask = getattr(values, "_mask", None)
+    if isinstance(data, np.ndarray) and isinstance(mask, np.ndarray):
+        return data, mask
+    else:
+        return None
+
+
+def _get_tz(dtype):
+    """
+    For a tz-aware datetime dtype, returns its time zone as a zone name or a
+    fixed offset in seconds; otherwise none.
+    """
+    if not isinstance(dtype, pd.DatetimeTZDtype):
+        return None
+    tz = dtype.tz
+    # zoneinfo zones have a key; pytz and dateutil zones, a zone name.
+    name = getattr(tz, "key", None) or getattr(tz, "zone", None)
+    if name is not None:
+        return name
+    offset = tz.utcoffset(None)
+    if offset is None:
+        raise TypeError(f"unsupported time zone: {tz}")
+    return int(offset.total_seconds())
+
+
 def from_dataframe(df, cfg, names=container.ALL):
     tbl = table.Table(cfg)
 
-    def get_values(series):
-        if series.dtype.name == "category":
-            # Construct an explicit array of values.
-            # FIXME: Wasteful.  We should instead read through the categories.
-            return series.cat.categories.values[series.cat.codes]
+    def add(add_column, name, values):
+        tz = _get_tz(values.dtype)
+        masked = _get_masked(values)
+        if masked is not None:
+            # Show nulls from the mask, rather than converting to objects.
+            data, mask = masked
+            add_column(name, data, mask=mask)
+        elif tz is not None:
+            # The UTC ticks, without copying.
+            add_column(
+                name, np.asarray(values, dtype=f"datetime64[{values.unit}]"),
+                tz=tz)
+        elif isinstance(values, pd.Categorical):
+            # Pass the codes and categories, so that each category is
+            # formatted once.
+            add_column(
+                name, _get_array(values.categories.values), codes=values.codes)
         else:
-            return series.values
+            add_column(name, _get_array(values))
 
     if cfg["index"]["show"]:
         idx = df.index
-        if isinstance(idx, pd.core.index.MultiIndex):
-            for name, labels, levels in zip(idx.names, idx.labels, idx.levels):
-                # FIXME: Wasteful.  Handle like category columns.
-                tbl.add_index_column(name, levels.values[labels])
+        if isinstance(idx, pd.MultiIndex):
+            # Older pandas versions call the codes "labels".
+            codes = idx.codes if hasattr(idx, "codes") else idx.labels
+            for name, level_codes, levels in zip(idx.names, codes, idx.levels):
+                tbl.add_index_column(
+                    name, _get_array(levels.values), codes=level_codes)
         else:
-            tbl.add_index_column(idx.name, get_values(idx))
+            add(tbl.add_index_column, idx.name, idx.array)
 
     names = container.select_ordered(tuple(df.columns), names)
     for name in names:
         series = df[name]
-        arr = get_values(series)
-        tbl.add_column(series.name, arr)
+        add(tbl.add_column, series.name, series.array)
 
     tbl.finish()
     return tbl
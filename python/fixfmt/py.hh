@@ -383,6 +383,29 @@ public:
 };
 
 
+/**
+ * Guard to release the GIL, and reacquire it on destruction.  No Python API
+ * may be used while it is released.
+ */
+class ReleaseGIL
+{
+private:
+
+  PyThreadState* const state_;
+
+public:
+
+  ReleaseGIL() : state_(PyEval_SaveThread()) {}
+  ~ReleaseGIL() { PyEval_RestoreThread(state_); }
+
+  ReleaseGIL(ReleaseGIL const&) = delete;
+  ReleaseGIL(ReleaseGIL&&) = delete;
+  void operator=(ReleaseGIL const&) = delete;
+  void operator=(ReleaseGIL&&) = delete;
+
+};
+
+
 //==============================================================================
 
 class Object
@@ -1206,6 +1229,17 @@ public:
 
   Py_buffer* operator->() { return &buffer_; }
 
+  /**
+   * Returns the stride of a one-dimensional buffer, in bytes; possibly
+   * negative.  Buffers requested without strides are contiguous.
+   */
+  Py_ssize_t 
+  get_stride() 
+    const 
+  { 
+    return buffer_.strides == nullptr ? buffer_.itemsize : buffer_.strides[0];
+  }
+
 private:
 
   Py_buffer buffer_;
@@ -0,0 +1,406 @@
+"""
+Row selections: orderings and subsets of a table's rows.
+
+A selection is an int64 array of row indices, which `Table.select()` applies
+as rows are rendered, so columns are never reordered or copied.
+"""
+
+import numpy as np
+
+from   . import _ext
+from   . import arrow
+
+#-------------------------------------------------------------------------------
+
+def _get_sort_keys(arr):
+    """
+    Returns arrays by which to sort `arr`, for `_ext.argsort()`.
+
+    Nulls of a masked array, NaT, and None objects sort last.  Strings and
+    other objects are sorted by their ranks, for which only the key is
+    copied.
+    """
+    mask = None
+    if arrow.is_arrow(arr):
+        arr = arr if isinstance(arr, arrow.ArrowArray) else (
+            arrow.ArrowArray(arr) if hasattr(arr, "__arrow_c_array__")
+            else arrow.ArrowChunks(arr))
+        if arr.values is None:
+            raise TypeError(f"can't sort by Arrow {arr.format} array")
+        arr, mask = arr.values, arr.mask
+    elif isinstance(arr, np.ma.MaskedArray):
+        arr, mask = arr.data, np.ma.getmaskarray(arr)
+    else:
+        arr = np.asarray(arr)
+
+    kind = arr.dtype.kind
+    null = None
+    if kind in "Mm":
+        # NaT is the smallest int64, so sort it as a null instead.
+        null = np.isnat(arr)
+        arr = arr.view("i8")
+    elif kind == "O":
+        # None isn't comparable to other objects, so rank only the others
+        # and sort None as a null.
+        null = np.equal(arr, None)
+        if null.any():
+            ranks = np.zeros(len(arr), dtype=np.int64)
+            _, ranks[~null] = np.unique(arr[~null], return_inverse=True)
+            arr = ranks
+        else:
+            _, arr = np.unique(arr, return_inverse=True)
+    elif kind in "SU":
+        _, arr = np.unique(arr, return_inverse=True)
+    elif kind not in "biuf":
+        raise TypeError(f"can't sort by {arr.dtype} array")
+    if null is not None:
+        mask = null if mask is None else mask | null
+
+    if mask is None or not mask.any():
+        return [arr]
+    else:
+        return [mask.view("u1"), arr]
+
+
+def argsort(keys, *, descending=False, limit=None):
+    """
+    Returns the order of rows sorted by `keys`, as row indices.
+
+    The sort is stable.  Floating point NaNs, NaT, None objects, and nulls
+    sort last.
+
+    :param keys:
+      An array by which to sort, or a sequence of arrays, the first of which
+      is the primary key.  Arrays may be numpy arrays, including masked
+      arrays, or Arrow arrays.
+    :param descending:
+      Whether to sort descending, or a sequence of these, one for each key.
+    :param limit:
+      If not none, returns only this many leading rows, as for the top N;
+      this is faster than a full sort.
+    :return:
+      An int64 array of row indices, for `Table.select()`.
+    """
+    if isinstance(keys, (list, tuple)):
+        descending = (
+            tuple(descending) if isinstance(descending, (list, tuple))
+            else (descending, ) * len(keys))
+        if len(descending) != len(keys):
+            raise ValueError("descending length doesn't match keys")
+    else:
+        keys = (keys, )
+        descending = (descending, )
+
+    sort_keys = []
+    sort_descending = []
+    for key, desc in zip(keys, descending):
+        key_keys = _get_sort_keys(key)
+        sort_keys.extend(key_keys)
+        # Sort the mask, if any, ascending, so nulls are last.
+        sort_descending.extend([False] * (len(key_keys) - 1) + [bool(desc)])
+
+    length = len(sort_keys[0])
+    num = length if limit is None else max(0, min(limit, length))
+    rows = np.empty(num, dtype=np.int64)
+    _ext.argsort(tuple(sort_keys), rows, tuple(sort_descending))
+    return rows
+
+
+#-------------------------------------------------------------------------------
+# Row filters
+
+def _get_column(arr):
+    """
+    Returns `(values, mask, arrow)` for an array to filter: its values as a
+    numpy array, or none for Arrow strings; a boolean array of its nulls, or
+    none if it has none; and its `ArrowArray`, if it is one.
+    """
+    if arrow.is_arrow(arr):
+        if not isinstance(arr, arrow.ArrowArray):
+            arr = arrow.ArrowArray(arr)
+        if arr.dictionary is not None:
+            raise TypeError("can't filter Arrow dictionary array")
+        return arr.values, arr.mask, arr
+    elif isinstance(arr, np.ma.MaskedArray):
+        mask = np.ma.getmaskarray(arr)
+        return arr.data, mask if mask.any() else None, None
+    else:
+        arr = np.asarray(arr)
+        mask = None
+        if arr.dtype.kind == "O":
+            mask = np.equal(arr, None)
+        elif arr.dtype.kind in "Mm":
+            mask = np.isnat(arr)
+        return arr, mask if mask is not None and mask.any() else None, None
+
+
+def _not_null(spec, values, mask):
+    """
+    Excludes nulls from `spec`.
+    """
+    if mask is not None:
+        spec = ("all", spec, ("not", ("mask", mask.view("u1"))))
+    if values is not None and values.dtype.kind == "f":
+        spec = ("all", spec, ("not", ("isnan", values)))
+    return spec
+
+
+def _get_number(values, value):
+    """
+    Returns `value` to compare to `values`, which is an int64 tick for
+    datetime or timedelta values.
+    """
+    kind = values.dtype.kind
+    if kind in "Mm":
+        return int(np.array(value).astype(values.dtype).view("i8"))
+    elif kind in "biuf":
+        if isinstance(value, (np.integer, np.bool_)):
+            value = int(value)
+        elif isinstance(value, np.floating):
+            value = float(value)
+        if not isinstance(value, (int, float)):
+            raise TypeError(f"can't compare {values.dtype} to {value!r}")
+        if kind != "f" and isinstance(value, int):
+            # Integer values are compared as uint64 or int64.
+            lo, hi = (
+                (0, 2**64) if kind == "u" and values.dtype.itemsize == 8
+                else (-2**63, 2**63))
+            if not lo <= value < hi:
+                raise ValueError(f"can't compare {values.dtype} to {value}")
+        return value
+    else:
+        raise TypeError(f"can't compare {values.dtype} array")
+
+
+def _get_ticks(values):
+    """
+    Returns numeric values to compare, viewing datetime and timedelta values
+    as int64 ticks.
+    """
+    return values.view("i8") if values.dtype.kind in "Mm" else values
+
+
+def _get_string_spec(op, pattern, values, mask, arr):
+    """
+    Returns the spec of a string condition.
+    """
+    if arr is not None:
+        if arr.max_length is None:
+            raise TypeError(f"Arrow {arr.format} array isn't strings")
+        strs = arr.capsules
+    elif values.dtype.kind in "OSU":
+        if values.dtype.kind == "U":
+            values = values.astype(object)
+        # Match each distinct string only once.
+        strs = _ext.StrArena(values, intern=True)
+    else:
+        raise TypeError(f"{values.dtype} array isn't strings")
+    return _not_null(("str", op, strs, str(pattern)), None, mask)
+
+
+
+class Expr:
+    """
+    A row filter expression.
+
+    Combine expressions with `&`, `|`, and `~`.  Comparisons and other
+    conditions on a column don't match its null entries, nor NaNs; however,
+    the negation of one does.
+    """
+
+    def __and__(self, other):
+        return _Combine("all", self, other)
+
+
+    def __or__(self, other):
+        return _Combine("any", self, other)
+
+
+    def __invert__(self):
+        return _Not(self)
+
+
+    def _compile(self, arrs):
+        """
+        Returns the `_ext.filter_rows()` spec of the expression, over arrays
+        by name `arrs`.
+        """
+        raise NotImplementedError("_compile")
+
+
+
+class _Combine(Expr):
+
+    def __init__(self, op, *exprs):
+        self.__op = op
+        self.__exprs = exprs
+
+
+    def _compile(self, arrs):
+        return (self.__op, ) + tuple( e._compile(arrs) for e in self.__exprs )
+
+
+
+class _Not(Expr):
+
+    def __init__(self, expr):
+        self.__expr = expr
+
+
+    def _compile(self, arrs):
+        return ("not", self.__expr._compile(arrs))
+
+
+
+class _Condition(Expr):
+
+    def __init__(self, name, compile):
+        self.__name = name
+        self.__compile = compile
+
+
+    def _compile(self, arrs):
+        return self.__compile(*_get_column(arrs[self.__name]))
+
+
+
+class col(Expr):
+    """
+    A column, by name, on which to build filter expressions.
+
+    As an expression itself, matches where a boolean column is true.
+    """
+
+    def __init__(self, name):
+        self.__name = name
+
+
+    def __condition(self, compile):
+        return _Condition(self.__name, compile)
+
+
+    def _compile(self, arrs):
+        values, mask, _ = _get_column(arrs[self.__name])
+        if values is None or values.dtype.kind != "b":
+            raise TypeError(f"column {self.__name} isn't boolean")
+        return _not_null(
+            ("mask", np.ascontiguousarray(values).view("u1")), None, mask)
+
+
+    def __compare(self, op, value):
+        def compile(values, mask, arr):
+            if values is None or values.dtype.kind in "OSU":
+                if op not in ("==", "!="):
+                    raise TypeError("can't order strings")
+                spec = _get_string_spec("==", value, values, mask, arr)
+                return spec if op == "==" else _not_null(
+                    ("not", spec), None, mask)
+            spec = ("cmp", op, _get_ticks(values), _get_number(values, value))
+            return _not_null(spec, values, mask)
+
+        return self.__condition(compile)
+
+
+    def __eq__(self, value): return self.__compare("==", value)
+    def __ne__(self, value): return self.__compare("!=", value)
+    def __lt__(self, value): return self.__compare("<" , value)
+    def __le__(self, value): return self.__compare("<=", value)
+    def __gt__(self, value): return self.__compare(">" , value)
+    def __ge__(self, value): return self.__compare(">=", value)
+
+    __hash__ = Expr.__hash__
+
+
+    def between(self, lo, hi):
+        """
+        Matches values from `lo` through `hi`, inclusive.
+        """
+        def compile(values, mask, arr):
+            if values is None or values.dtype.kind not in "biufMm":
+                raise TypeError("can't compare strings")
+            spec = (
+                "between", _get_ticks(values),
+                _get_number(values, lo), _get_number(values, hi))
+            return _not_null(spec, values, mask)
+
+        return self.__condition(compile)
+
+
+    def isnull(self):
+        """
+        Matches nulls, including NaNs and NaTs.
+        """
+        def compile(values, mask, arr):
+            specs = []
+            if mask is not None:
+                specs.append(("mask", mask.view("u1")))
+            if values is not None and values.dtype.kind == "f":
+                specs.append(("isnan", values))
+            return ("any", ) + tuple(specs)
+
+        return self.__condition(compile)
+
+
+    def notnull(self):
+        """
+        Matches entries that are not null.
+        """
+        return ~self.isnull()
+
+
+    def __string(self, op, pattern):
+        return self.__condition(
+            lambda values, mask, arr: _get_string_spec(
+                op, pattern, values, mask, arr))
+
+
+    def startswith(self, prefix):
+        return self.__string("startswith", prefix)
+
+
+    def endswith(self, suffix):
+        return self.__string("endswith", suffix)
+
+
+    def contains(self, substring):
+        return self.__string("contains", substring)
+
+
+
+def where(arrs, expr):
+    """
+    Returns the rows that match a filter expression, as row indices.
+
+    The expression is evaluated natively, a block of rows at a time, so the
+    columns aren't copied; only string columns of Python objects are
+    converted, once per distinct string.
+
+    :param arrs:
+      A mapping from name to array, such as a dict or data frame, of the
+      columns `expr` references.  Arrays may be numpy arrays, including
+      masked arrays, or Arrow arrays.
+    :param expr:
+      An `Expr`, built from `col()`.
+    :return:
+      An int64 array of row indices, for `Table.select()`.
+    """
+    spec = expr._compile(arrs)
+    length = _get_length(arrs)
+    return np.frombuffer(_ext.filter_rows(spec, length), dtype=np.int64)
+
+
+def _get_length(arrs):
+    def length(arr):
+        if arrow.is_arrow(arr) and not hasattr(arr, "__len__"):
+            arr = arrow.ArrowArray(arr)
+        return len(arr)
+
+    try:
+        return len(arrs.index)
+    except AttributeError:
+        lengths = { length(a) for a in arrs.values() }
+        if len(lengths) != 1:
+            raise ValueError("array lengths don't match")
+        return lengths.pop()
+
+
@@ -1,8 +1,10 @@
 import copy
+import os
 import numpy as np
 
 from   . import string_length, palide, center, Bool, Number, String, is_fmt
 from   . import _ext
+from   . import arrow
 from   . import npfmt
 from   .lib import ansi
 
@@ -33,6 +35,21 @@ DEFAULT_CFG = {
     },
     "data": {
         "max_rows"                  : "terminal",
+        "intern_strings"            : True,
+        # Threads with which to format rows; 0 for all cores.
+        "num_threads"               : 1,
+        # Rows each thread formats at a time.
+        "block_size"                : 16384,
+        # Text for null entries of masked columns.
+        "null"                      : u"<NA>",
+        # Leading rows of chunked and streamed Arrow columns from which to
+        # choose formatters; all rows, or the first batch of a stream, if
+        # none.
+        "analysis_rows"             : None,
+        # Rows from which to choose formatters: "all", or "visible" for
+        # only the rows shown, as limited by "max_rows" and the selection.
+        # Paging always chooses formatters from all rows.
+        "analyze"                   : "all",
     },
     "formatters": {
         "by_name"                   : {},
@@ -235,9 +252,20 @@ def _colorize(cfg):
 
 #-------------------------------------------------------------------------------
 
-def _get_formatter(name, arr, cfg):
+def _get_formatter(
+        name, arr, cfg, strs=None, tz=None, mask=None, null=None):
     """
     Constructs a formatter for a named array.
+
+    :param strs:
+      For an object array, its `StrArena`, if already converted.
+    :param tz:
+      For a datetime64 array, the time zone in which to show times.
+    :param mask:
+      A boolean array, true for null entries, which aren't analyzed, or none.
+    :param null:
+      Text for null entries, if there are any; the formatter is widened to
+      fit it.
     """
     # Start with the overall default formatter configuration
     fmt_cfg = cfg["default"]
@@ -263,8 +291,12 @@ def _get_formatter(name, arr, cfg):
     min_width = fmt_cfg["min_width"]
     if fmt_cfg["name_width"]:
         min_width = max(min_width, string_length(name))
+    if null is not None:
+        min_width = max(min_width, string_length(null))
 
-    return npfmt.choose_formatter(arr, min_width=min_width, cfg=fmt_cfg)
+    return npfmt.choose_formatter(
+        arr if strs is None else strs, min_width=min_width, cfg=fmt_cfg,
+        tz=tz, mask=mask)
 
 
 def _get_header_position(fmt):
@@ -282,6 +314,120 @@ def _get_header_position(fmt):
         return 1  # FIXME: Constant.
 
 
+def _get_strs(arr, intern=False):
+    """
+    For an object array, returns its `StrArena`; otherwise none.
+
+    The arena is used both to choose the formatter and to render the column, so
+    that each object is converted with `str()` only once.
+
+    :param intern:
+      If true, intern strings, so that each distinct string is formatted
+      only once.  Bytes arrays are also interned into an arena.
+    """
+    if arr.dtype.kind == "O" or (intern and arr.dtype.kind == "S"):
+        return _ext.StrArena(arr, intern=intern)
+    else:
+        return None
+
+
+def _get_mask(arr, mask=None):
+    """
+    Returns the values of `arr`, and a contiguous boolean mask of its null
+    entries or none.
+
+    :param arr:
+      An array, possibly a masked array.
+    :param mask:
+      A boolean array, true for null entries, or none.
+    """
+    if isinstance(arr, np.ma.MaskedArray):
+        if mask is None and arr.mask is not np.ma.nomask:
+            mask = np.ma.getmaskarray(arr)
+        arr = arr.data
+    if mask is not None:
+        mask = np.ascontiguousarray(mask, dtype=bool)
+        if mask.shape != arr.shape:
+            raise ValueError("mask shape doesn't match")
+    return arr, mask
+
+
+def _get_null_pad_pos(kind):
+    """
+    Returns the pad position for null text in a column of dtype `kind`.
+    """
+    # Right-justify, like numbers.
+    return 0.0 if kind in "fium" else 1.0  # FIXME: Constants.
+
+
+def _add_array(
+        table, arr, fmt, strs=None, mask=None, null="", objects=False):
+    """
+    Adds an array as a column of an extension table.
+
+    :param mask:
+      A boolean array, true for entries to show as `null`.  Supported for
+      numerical, bool, datetime64, and timedelta64 arrays.
+    :param objects:
+      If true, converts each object of an object array with `str()` only
+      when its row is rendered, rather than all of them up front.
+    """
+    kind = arr.dtype.kind
+    if mask is None:
+        null_args = {}
+    elif kind in "fiubMm":
+        null_args = dict(
+            mask=mask, null=null, null_pad_pos=_get_null_pad_pos(kind))
+    else:
+        raise TypeError("can't mask dtype: {}".format(arr.dtype))
+
+    name = arr.dtype.name
+    if name in {
+        "int8", "int16", "int32", "int64",
+        "uint8", "uint16", "uint32", "uint64",
+        "float32", "float64", "bool"
+    }:
+        getattr(table, "add_" + name)(arr, fmt, **null_args)
+    elif strs is not None:
+        table.add_str_arena(strs, fmt)
+    elif name == "object" and objects:
+        table.add_str_object(arr, fmt)
+    elif name == "object":
+        table.add_str_arena(_get_strs(arr), fmt)
+    elif arr.dtype.kind in "U":
+        table.add_ucs32(arr.dtype.itemsize, arr, fmt)
+    elif arr.dtype.kind in "S":
+        table.add_utf8(arr.dtype.itemsize, arr, fmt)
+    elif arr.dtype.kind == "M":
+        # View the ticks, without copying.
+        ticks = arr.view("int64")
+        if isinstance(fmt, _ext.TickDate):
+            table.add_tick_date(ticks, fmt, **null_args)
+        else:
+            table.add_tick_time(ticks, fmt, **null_args)
+    elif arr.dtype.kind == "m":
+        table.add_tick_duration(arr.view("int64"), fmt, **null_args)
+    else:
+        raise TypeError("unsupported dtype: {}".format(arr.dtype))
+
+
+# Number of rows to render natively at a time, per thread.
+FORMAT_CHUNK_SIZE = 65536
+
+def _format_rows(table, begin, end, cfg):
+    """
+    Generates formatted rows `begin` through `end` of an extension table.
+    """
+    num_threads = cfg["num_threads"]
+    block_size  = cfg["block_size"]
+    chunk_size  = FORMAT_CHUNK_SIZE * max(
+        1, (os.cpu_count() or 1) if num_threads == 0 else num_threads)
+    for start in range(begin, end, chunk_size):
+        yield from table.format_rows(
+            start, min(start + chunk_size, end),
+            num_threads=num_threads, block_size=block_size)
+
+
 #-------------------------------------------------------------------------------
 
 class Table:
@@ -296,61 +442,243 @@ class Table:
         self.__num_idx  = 0
         # The underlying table.
         self.__table    = _ext.Table()
+        # If analyzing visible rows only, the strings, columns, and selection
+        # to add to the underlying table, once the visible rows are known,
+        # and again if all rows are analyzed after all.
+        self.__pending  = [] if cfg["data"]["analyze"] == "visible" else None
+        # Whether the underlying table has been built from the pending
+        # strings, columns, and selection: none if not, else "visible" or
+        # "all" for the rows from which formatters were chosen.
+        self.__built    = None
 
         # Start the table.
         self.add_string(self.__cfg["row"]["separator"]["start"])
 
 
-    def __add_array(self, arr, fmt):
-        table = self.__table
+    def __add_array(self, name, arr, fmt, codes, tz, mask, visible=None):
+        """
+        Adds an array as a column, choosing a formatter if none is given.
+        Returns the formatter.
 
-        name = arr.dtype.name
-        if name in {
-            "int8", "int16", "int32", "int64",
-            "uint8", "uint16", "uint32", "uint64",
-            "float32", "float64", "bool"
-        }:
-            getattr(table, "add_" + name)(arr, fmt)
-        elif name == "object":
-            table.add_str_object(arr, fmt)
-        elif arr.dtype.kind in "U":
-            table.add_ucs32(arr.dtype.itemsize, arr, fmt)
-        elif arr.dtype.kind in "S":
-            table.add_utf8(arr.dtype.itemsize, arr, fmt)
-        elif name.startswith("datetime64"):  # FIXME: Sloppy.
-            table.add_tick_time(arr.astype("int64"), fmt)
+        :param visible:
+          If not none, the indices of the rows shown, from which alone to
+          choose the formatter.  Arrow arrays are analyzed in full.
+        """
+        cfg = self.__cfg
+        if arrow.is_arrow(arr):
+            if codes is not None or mask is not None:
+                raise ValueError("Arrow array can't have codes or mask")
+            return self.__add_arrow(name, self.__get_arrow(arr), fmt, tz)
+
+        null = cfg["data"]["null"]
+        intern = cfg["data"]["intern_strings"]
+        arr, mask = _get_mask(arr, mask)
+        if codes is not None and mask is not None:
+            raise ValueError("can't mask categorical column")
+        # Convert a column of objects up front only if all its rows are
+        # analyzed; otherwise, only the visible objects are converted.
+        lazy = visible is not None and codes is None
+        strs = None if lazy else _get_strs(arr, intern)
+        if fmt is None:
+            if visible is None:
+                sample, sample_mask, sample_strs = arr, mask, strs
+            elif codes is None:
+                sample = arr[visible]
+                sample_mask = None if mask is None else mask[visible]
+                sample_strs = _get_strs(sample, intern)
+            else:
+                # The categories of the visible rows.
+                used = np.unique(np.asarray(codes)[visible])
+                sample = arr[used[used >= 0]]
+                sample_mask = None
+                sample_strs = _get_strs(sample, intern)
+            fmt = _get_formatter(
+                name, sample, cfg["formatters"], sample_strs, tz=tz,
+                mask=sample_mask,
+                null=null if sample_mask is not None and sample_mask.any()
+                     else None)
+
+        if codes is None:
+            _add_array(
+                self.__table, arr, fmt, strs, mask=mask, null=null,
+                objects=lazy)
+        else:
+            # Format each category once, into a table of its own, and look up
+            # the formatted categories by code.
+            categories = _ext.Table()
+            _add_array(categories, arr, fmt, strs)
+            self.__table.add_categorical(codes, categories)
+        return fmt
+
+
+    def __get_arrow(self, arr):
+        """
+        Returns an Arrow array, or the chunks of a chunked array or stream,
+        which may be added more than once.
+        """
+        if isinstance(arr, (arrow.ArrowArray, arrow.ArrowChunks)):
+            return arr
+        elif hasattr(arr, "__arrow_c_array__"):
+            return arrow.ArrowArray(arr)
         else:
-            raise TypeError("unsupported dtype: {}".format(arr.dtype))
+            return arrow.ArrowChunks(
+                arr, analysis_rows=self.__cfg["data"]["analysis_rows"])
+
+
+    def __add_arrow(self, name, arr, fmt, tz):
+        """
+        Adds an Arrow array or chunks as a column, without copying its data.
+        """
+        null = self.__cfg["data"]["null"]
+        # For a dictionary array, the formatter is for the dictionary's
+        # values, each of which is formatted once.
+        vals = arr if arr.dictionary is None else arr.dictionary
+        if fmt is None:
+            fmt = _get_formatter(
+                name, vals if vals.values is None else vals.values,
+                self.__cfg["formatters"],
+                strs=None if vals.max_length is None else vals,
+                tz=arr.tz if tz is None else tz, mask=vals.mask,
+                null=null if arr.null_count != 0 or vals.null_count != 0
+                     else None)
+        self.__table.add_arrow(
+            arr.capsules, fmt,
+            null=null, null_pad_pos=_get_null_pad_pos(vals.dtype.kind))
+        return fmt
+
+
+    def __build(self, all_rows=False):
+        """
+        Adds pending strings, columns, and selection to the underlying table,
+        choosing formatters from the visible rows only.
+
+        :param all_rows:
+          If true, chooses formatters from all rows instead, rebuilding the
+          underlying table if it was built from the visible rows.
+        """
+        pending = self.__pending
+        built = self.__built
+        if pending is None or built == "all" or (built and not all_rows):
+            return
+        if built is not None:
+            self.__table = _ext.Table()
+        self.__built = "all" if all_rows else "visible"
+
+        columns = [ p for p in pending if p[0] == "column" ]
+        rows = next(( p[1] for p in pending if p[0] == "select" ), None)
+        visible = None
+        if len(columns) > 0 and not all_rows:
+            def length(column):
+                _, _, name, arr, fmt, codes, tz, mask = column
+                if arrow.is_arrow(arr) and not hasattr(arr, "__len__"):
+                    return None
+                return len(arr if codes is None else codes)
+
+            lengths = [ n for n in map(length, columns) if n is not None ]
+            num_rows = min(lengths) if len(lengths) > 0 else 0
+            if rows is not None:
+                if len(rows) > 0 and not (
+                        0 <= rows.min() and rows.max() < num_rows):
+                    raise IndexError("row out of range")
+                num_rows = len(rows)
+
+            max_lines = self.__get_max_lines()
+            num_top, num_bottom = (
+                (num_rows, 0) if max_lines is None
+                else _ext.get_visible(
+                    num_rows, max_lines,
+                    self.__cfg["row_ellipsis"]["position"]))
+            visible = np.concatenate((
+                np.arange(num_top),
+                np.arange(num_rows - num_bottom, num_rows),
+            )).astype(np.int64)
+            if rows is not None:
+                visible = rows[visible]
+
+        for op, *args in pending:
+            if op == "string":
+                self.__table.add_string(*args)
+            elif op == "column":
+                i, name, arr, fmt, codes, tz, mask = args
+                self.__fmts[i] = self.__add_array(
+                    name, arr, fmt, codes, tz, mask, visible=visible)
+        if rows is not None:
+            self.__table.select(rows)
 
 
     def add_string(self, string):
-        self.__table.add_string(string)
-
-
-    def add_index_column(self, name, arr, fmt=None):
+        if self.__pending is not None:
+            self.__pending.append(("string", string))
+        if self.__pending is None or self.__built:
+            self.__table.add_string(string)
+
+
+    def add_index_column(
+            self, name, arr, fmt=None, *, codes=None, tz=None, mask=None):
+        """
+        Adds an index column.
+
+        :param codes:
+          If not none, an array of integer codes into `arr`, which contains
+          the categories; each category is formatted only once.
+        :param tz:
+          For UTC datetime64 values, the time zone in which to show them, as
+          a zone name or a fixed offset in seconds east of UTC.
+        :param mask:
+          If not none, a boolean array, true for null entries, which are
+          shown as the "null" data cfg.  A masked `arr` carries its own mask.
+
+        `arr` may also be an Arrow array, or any object that implements the
+        Arrow PyCapsule interface, which is imported without copying.  A
+        chunked array or other Arrow stream is rendered chunk by chunk.
+        """
         assert self.__num_idx == len(self.__fmts), \
             "can't add index after normal column"
 
         if self.__num_idx > 0:
             self.add_string(self.__cfg["row"]["separator"]["between"])
 
-        if fmt is None:
-            fmt = _get_formatter(name, arr, self.__cfg["formatters"])
-        self.__add_array(arr, fmt)
-        self.__names.append(name)
-        self.__fmts.append(fmt)
+        self.__add_column(name, arr, fmt, codes, tz, mask)
         self.__num_idx += 1
 
 
-    def add_column(self, name, arr, fmt=None):
+    def add_column(
+            self, name, arr, fmt=None, *, codes=None, tz=None, mask=None):
+        """
+        Adds a column.
+
+        :param codes:
+          If not none, an array of integer codes into `arr`, which contains
+          the categories; each category is formatted only once.
+        :param tz:
+          For UTC datetime64 values, the time zone in which to show them, as
+          a zone name or a fixed offset in seconds east of UTC.
+        :param mask:
+          If not none, a boolean array, true for null entries, which are
+          shown as the "null" data cfg.  A masked `arr` carries its own mask.
+
+        `arr` may also be an Arrow array, or any object that implements the
+        Arrow PyCapsule interface, which is imported without copying.  A
+        chunked array or other Arrow stream is rendered chunk by chunk.
+        """
         if self.__num_idx > 0 and self.__num_idx == len(self.__fmts):
             self.add_string(self.__cfg["row"]["separator"]["index"])
         elif len(self.__fmts) > 0:
             self.add_string(self.__cfg["row"]["separator"]["between"])
 
-        if fmt is None:
-            fmt = _get_formatter(name, arr, self.__cfg["formatters"])
-        self.__add_array(arr, fmt)
+        self.__add_column(name, arr, fmt, codes, tz, mask)
+
+
+    def __add_column(self, name, arr, fmt, codes, tz, mask):
+        if self.__pending is not None:
+            if arrow.is_arrow(arr):
+                # A stream is read once, so keep its chunks.
+                arr = self.__get_arrow(arr)
+            self.__pending.append(
+                ("column", len(self.__fmts), name, arr, fmt, codes, tz, mask))
+        if self.__pending is None or self.__built:
+            fmt = self.__add_array(name, arr, fmt, codes, tz, mask)
+        # Otherwise, choose the formatter once the visible rows are known.
         self.__names.append(name)
         self.__fmts.append(fmt)
 
@@ -359,7 +687,28 @@ class Table:
         self.add_string(self.__cfg["row"]["separator"]["end"])
 
 
+    def select(self, rows):
+        """
+        Shows only `rows`, in that order, or all rows if none.
+
+        Columns are read through the selection as rows are rendered, so
+        aren't reordered or copied.
+
+        :param rows:
+          Row indices, such as from `rows.argsort()`.
+        """
+        if rows is not None:
+            rows = np.ascontiguousarray(rows, dtype=np.int64)
+        if self.__pending is not None:
+            self.__pending = [ p for p in self.__pending if p[0] != "select" ]
+            if rows is not None:
+                self.__pending.append(("select", rows))
+        if self.__pending is None or self.__built:
+            self.__table.select(rows)
+
+
     def _fmt_header(self):
+        self.__build()
         cfg = self.__cfg["header"]
         assert string_length(cfg["style"]["prefix"]) == 0
         assert string_length(cfg["style"]["suffix"]) == 0
@@ -392,6 +741,7 @@ class Table:
 
 
     def _fmt_line(self, cfg):
+        self.__build()
         if cfg["show"]:
             # FIXME: Relax this.
             if string_length(cfg["line"]) != 1:
@@ -423,11 +773,20 @@ class Table:
         return self._fmt_line(self.__cfg["bottom"])
 
 
-    # FIXME: By screen (repeating header?)
     # FIXME: Do what when it's too wide???
 
-    def _format(self):
+    def __get_max_lines(self):
+        """
+        Returns the number of lines in which to show rows, including an
+        ellipsis line, or none for all rows.
+        """
         cfg = self.__cfg
+        max_rows = cfg["data"]["max_rows"]
+        if max_rows == "terminal":
+            # FIXME
+            max_rows = ansi.get_terminal_size().lines - 1
+        if max_rows is None:
+            return None
 
         num_extra_rows  = sum([
             cfg["top"]["show"],
@@ -435,62 +794,166 @@ class Table:
             cfg["underline"]["show"],
             cfg["bottom"]["show"],
         ])
+        return max_rows - num_extra_rows
 
-        max_rows = cfg["data"]["max_rows"]
-        if max_rows == "terminal":
-            # FIXME
-            max_rows = ansi.get_terminal_size().lines - 1
+
+    def __get_visible(self):
+        """
+        Returns the numbers of leading and trailing rows to show, and the
+        ellipsis line between them, or none if all rows are shown.
+        """
+        self.__build()
+        cfg = self.__cfg
+        table = self.__table
+        num_rows = len(table)
+
+        max_lines = self.__get_max_lines()
+        if max_lines is None:
+            return num_rows, 0, None
+
+        cfg_ell = cfg["row_ellipsis"]
+        num_rows_top, num_rows_bottom = _ext.get_visible(
+            num_rows, max_lines, cfg_ell["position"])
+        num_rows_skipped = num_rows - num_rows_top - num_rows_bottom
+        if num_rows_skipped == 0:
+            return num_rows, 0, None
+
+        ell = cfg_ell["format"].format(
+            bottom  =num_rows_bottom,
+            rows    =num_rows,
+            skipped =num_rows_skipped,
+            top     =num_rows_top,
+        )
+        ell_start   = cfg_ell["separator"]["start"]
+        ell_end     = cfg_ell["separator"]["end"]
+        ell_pad     = cfg_ell["pad"]
+        ell_width   = (
+              table.width
+            - string_length(ell_start)
+            - string_length(ell_end))
+        ell         = center(ell, ell_width, ell_pad)
+        return num_rows_top, num_rows_bottom, ell_start + ell + ell_end
+
+
+    def _format(self):
+        cfg = self.__cfg
+        num_top, num_bottom, ell = self.__get_visible()
 
         yield self._fmt_top()
         yield self._fmt_header()
         yield self._fmt_underline()
 
         table = self.__table
-        num_rows = len(table)
-        if max_rows is None or num_rows <= max_rows - num_extra_rows:
-            for i in range(len(table)):
-                yield table(i)
+        if ell is None:
+            # All rows, a chunk at a time.
+            yield from _format_rows(table, 0, num_top, cfg["data"])
         else:
-            cfg_ell             = cfg["row_ellipsis"]
-            num_rows_top        = int(cfg_ell["position"] * max_rows)
-            num_rows_bottom     = max_rows - num_extra_rows - num_rows_top - 1
-            num_rows_skipped    = num_rows - num_rows_top - num_rows_bottom
-
-            # Print rows from the top.
-            for i in range(num_rows_top):
-                yield table(i)
-
-            # Print the row ellipsis.
-            ell = cfg_ell["format"].format(
-                bottom  =num_rows_bottom,
-                rows    =num_rows,
-                skipped =num_rows_skipped,
-                top     =num_rows_top,
-            )
-            ell_start   = cfg_ell["separator"]["start"]
-            ell_end     = cfg_ell["separator"]["end"]
-            ell_pad     = cfg_ell["pad"]
-            ell_width   = (
-                  table.width
-                - string_length(ell_start)
-                - string_length(ell_end))
-            ell         = center(ell, ell_width, ell_pad)
-            yield ell_start + ell + ell_end
-
-            # Print rows from the bottom.
-            for i in range(num_rows - num_rows_bottom, num_rows):
-                yield table(i)
+            # The leading rows, ellipsis, and trailing rows, in one call.
+            yield from table.format_visible(
+                num_top, num_bottom, ell,
+                num_threads=cfg["data"]["num_threads"],
+                block_size=cfg["data"]["block_size"])
 
         yield self._fmt_bottom()
 
 
+    def _get_fmts(self):
+        self.__build()
+        return list(self.__fmts)
+
+
+    def _fmt_rows(self):
+        """
+        Generates all formatted rows, without the header or an ellipsis.
+        """
+        self.__build()
+        yield from _format_rows(
+            self.__table, 0, len(self.__table), self.__cfg["data"])
+
+
     def format(self):
         yield from filter(None, self._format())
 
 
+    def __get_page_size(self, page_size):
+        if page_size is None:
+            page_size = self.__get_max_lines()
+            if page_size is None:
+                raise ValueError("no page size or max_rows")
+        if page_size < 1:
+            raise ValueError("page_size must be positive")
+        return page_size
+
+
+    def get_num_pages(self, page_size=None):
+        """
+        Returns the number of pages of rows, as for `format_page()`.
+        """
+        self.__build(all_rows=True)
+        page_size = self.__get_page_size(page_size)
+        return max(1, -(-len(self.__table) // page_size))
+
+
+    def format_page(self, page, page_size=None, *, repeat_header=True):
+        """
+        Generates the formatted lines of one page of rows.
+
+        Only the rows of the page are rendered, so any page costs the same,
+        however far into the table.  Formatters are chosen from all rows,
+        even if the "analyze" data cfg is "visible", so that pages align.
+
+        :param page:
+          The page number, from zero; negative to count from the end.
+        :param page_size:
+          Rows per page, or none for as many as fit in "max_rows" lines with
+          the header.
+        :param repeat_header:
+          If true, each page starts with the header and ends with the
+          bottom line, as a table of its own.  Otherwise, only the first
+          page has the header and the last the bottom line.
+        """
+        page_size = self.__get_page_size(page_size)
+        num_pages = self.get_num_pages(page_size)
+        if page < 0:
+            page += num_pages
+        if not 0 <= page < num_pages:
+            raise IndexError("page out of range")
+
+        if repeat_header or page == 0:
+            yield from filter(None, (
+                self._fmt_top(), self._fmt_header(), self._fmt_underline()))
+        num_rows = len(self.__table)
+        begin = page * page_size
+        yield from _format_rows(
+            self.__table, begin, min(begin + page_size, num_rows),
+            self.__cfg["data"])
+        if repeat_header or page == num_pages - 1:
+            bottom = self._fmt_bottom()
+            if bottom:
+                yield bottom
+
+
+    def format_text(self):
+        """
+        Returns the formatted table as one string, with lines separated by
+        newlines.  The visible rows are rendered in a single native call.
+        """
+        cfg = self.__cfg
+        num_top, num_bottom, ell = self.__get_visible()
+        head = filter(None, (
+            self._fmt_top(), self._fmt_header(), self._fmt_underline()))
+        body = self.__table.format_visible(
+            num_top, num_bottom, "" if ell is None else ell, line_end="\n",
+            num_threads=cfg["data"]["num_threads"],
+            block_size=cfg["data"]["block_size"])
+        bottom = self._fmt_bottom()
+        text = "".join( l + "\n" for l in head ) + body + (
+            bottom + "\n" if bottom else "")
+        return text[: -1]
+
+
     def print(self, print=print):
-        for line in self.format():
-            print(line)
+        print(self.format_text())
 
 
 
@@ -517,6 +980,73 @@ def from_arrays(arrs, cfg=DEFAULT_CFG):
     return tbl
 
 
+def format_stream(stream, cfg=DEFAULT_CFG):
+    """
+    Formats an Arrow stream, such as a record batch reader, as it is read.
+
+    Formatters are chosen from the leading batches, up to the "analysis_rows"
+    data cfg or the first batch; values in later batches that don't fit are
+    shown as the formatters show overflow.  Each later batch is then
+    rendered in place, without concatenating it, and released, so only one
+    batch is held at a time.  All rows are shown.
+
+    :param stream:
+      An object that implements `__arrow_c_stream__()`, or the stream
+      capsule it returns.  Each column of a stream of record batches is a
+      table column.
+    """
+    analysis_rows = cfg["data"]["analysis_rows"]
+    batches = arrow.iter_stream(stream)
+
+    # Read the leading batches, from which to choose formatters.
+    leading = []
+    num_rows = 0
+    for batch in batches:
+        columns = arrow.get_columns(batch)
+        if len(columns) == 0:
+            raise ValueError("no columns")
+        leading.append(columns)
+        num_rows += len(columns[0][1])
+        if analysis_rows is None or num_rows >= analysis_rows:
+            break
+    if len(leading) == 0:
+        return
+
+    def make_table(columns, fmts):
+        tbl = Table(cfg)
+        for (name, arr), fmt in zip(columns, fmts):
+            tbl.add_column(name, arr, fmt)
+        tbl.finish()
+        return tbl
+
+    # The leading batches, as chunked columns.
+    names = [ n for n, _ in leading[0] ]
+    columns = [
+        (n, arrow.ArrowChunks([ c[i][1] for c in leading ]))
+        for i, n in enumerate(names)
+    ]
+    tbl = make_table(columns, [None] * len(columns))
+    fmts = tbl._get_fmts()
+    del leading, columns
+
+    yield from filter(None, (
+        tbl._fmt_top(), tbl._fmt_header(), tbl._fmt_underline()))
+    yield from tbl._fmt_rows()
+    for batch in batches:
+        columns = arrow.get_columns(batch)
+        if [ n for n, _ in columns ] != names:
+            raise ValueError("stream columns changed")
+        yield from make_table(columns, fmts)._fmt_rows()
+    bottom = tbl._fmt_bottom()
+    if bottom:
+        yield bottom
+
+
+def print_stream(stream, cfg=DEFAULT_CFG, print=print):
+    for line in format_stream(stream, cfg):
+        print(line)
+
+
 #-------------------------------------------------------------------------------
 
 class RowTable:
@@ -0,0 +1,353 @@
+import ctypes
+import numpy as np
+import pytest
+
+import fixfmt._ext
+from   fixfmt import Number
+from   fixfmt.arrow import ArrowArray, ArrowChunks
+from   fixfmt.table import Table, format_stream, DEFAULT_CFG, update_cfg
+
+#-------------------------------------------------------------------------------
+# A minimal producer of the Arrow PyCapsule interface, so that we can test
+# without pyarrow.
+
+class _Schema(ctypes.Structure):
+    pass
+
+class _Array(ctypes.Structure):
+    pass
+
+_RELEASE_SCHEMA = ctypes.CFUNCTYPE(None, ctypes.POINTER(_Schema))
+_RELEASE_ARRAY = ctypes.CFUNCTYPE(None, ctypes.POINTER(_Array))
+
+_Schema._fields_ = [
+    ("format"       , ctypes.c_char_p),
+    ("name"         , ctypes.c_char_p),
+    ("metadata"     , ctypes.c_char_p),
+    ("flags"        , ctypes.c_int64),
+    ("n_children"   , ctypes.c_int64),
+    ("children"     , ctypes.c_void_p),
+    ("dictionary"   , ctypes.POINTER(_Schema)),
+    ("release"      , _RELEASE_SCHEMA),
+    ("private_data" , ctypes.c_void_p),
+]
+
+_Array._fields_ = [
+    ("length"       , ctypes.c_int64),
+    ("null_count"   , ctypes.c_int64),
+    ("offset"       , ctypes.c_int64),
+    ("n_buffers"    , ctypes.c_int64),
+    ("n_children"   , ctypes.c_int64),
+    ("buffers"      , ctypes.POINTER(ctypes.c_void_p)),
+    ("children"     , ctypes.c_void_p),
+    ("dictionary"   , ctypes.POINTER(_Array)),
+    ("release"      , _RELEASE_ARRAY),
+    ("private_data" , ctypes.c_void_p),
+]
+
+# The structs are owned by the producer, so release does nothing.
+_release_schema = _RELEASE_SCHEMA(lambda schema: None)
+_release_array = _RELEASE_ARRAY(lambda array: None)
+
+_capsule_new = ctypes.pythonapi.PyCapsule_New
+_capsule_new.restype = ctypes.py_object
+_capsule_new.argtypes = (ctypes.c_void_p, ctypes.c_char_p, ctypes.c_void_p)
+
+_SCHEMA_NAME = b"arrow_schema"
+_ARRAY_NAME = b"arrow_array"
+_STREAM_NAME = b"arrow_array_stream"
+
+class _Stream(ctypes.Structure):
+    pass
+
+_GET_SCHEMA = ctypes.CFUNCTYPE(
+    ctypes.c_int, ctypes.POINTER(_Stream), ctypes.POINTER(_Schema))
+_GET_NEXT = ctypes.CFUNCTYPE(
+    ctypes.c_int, ctypes.POINTER(_Stream), ctypes.POINTER(_Array))
+_GET_LAST_ERROR = ctypes.CFUNCTYPE(ctypes.c_char_p, ctypes.POINTER(_Stream))
+_RELEASE_STREAM = ctypes.CFUNCTYPE(None, ctypes.POINTER(_Stream))
+
+_Stream._fields_ = [
+    ("get_schema"       , _GET_SCHEMA),
+    ("get_next"         , _GET_NEXT),
+    ("get_last_error"   , _GET_LAST_ERROR),
+    ("release"          , _RELEASE_STREAM),
+    ("private_data"     , ctypes.c_void_p),
+]
+
+
+def _validity(valid):
+    return np.packbits(np.asarray(valid, dtype=bool), bitorder="little")
+
+
+class Producer:
+
+    def __init__(
+            self, format, length, buffers, *, null_count=0, offset=0,
+            dictionary=None, children=(), name="x"):
+        self.buffers = [
+            None if b is None else np.asarray(b) for b in buffers ]
+        self.addrs = (ctypes.c_void_p * len(buffers))(*(
+            None if b is None else b.ctypes.data for b in self.buffers))
+        self.dictionary = dictionary
+        self.children = children
+        self.schema = _Schema(
+            format=format.encode(), name=name.encode(),
+            n_children=len(children), release=_release_schema)
+        self.array = _Array(
+            length=length, null_count=null_count, offset=offset,
+            n_buffers=len(buffers), n_children=len(children),
+            buffers=self.addrs, release=_release_array)
+        if len(children) > 0:
+            self.child_schemas = (ctypes.POINTER(_Schema) * len(children))(
+                *( ctypes.pointer(c.schema) for c in children ))
+            self.child_arrays = (ctypes.POINTER(_Array) * len(children))(
+                *( ctypes.pointer(c.array) for c in children ))
+            self.schema.children = ctypes.addressof(self.child_schemas)
+            self.array.children = ctypes.addressof(self.child_arrays)
+        if dictionary is not None:
+            self.schema.dictionary = ctypes.pointer(dictionary.schema)
+            self.array.dictionary = ctypes.pointer(dictionary.array)
+
+
+    def __arrow_c_array__(self, requested_schema=None):
+        return (
+            _capsule_new(ctypes.addressof(self.schema), _SCHEMA_NAME, None),
+            _capsule_new(ctypes.addressof(self.array), _ARRAY_NAME, None),
+        )
+
+
+class StreamProducer:
+    """
+    Produces an Arrow stream of the arrays of `batches`, which are producers
+    with the same schema.
+    """
+
+    def __init__(self, batches):
+        self.batches = iter(batches)
+        self.schema = (
+            batches[0] if len(batches) > 0 else Producer("l", 0, [None, None])
+        ).schema
+        self.last = None
+        self.stream = _Stream(
+            get_schema=_GET_SCHEMA(self.__get_schema),
+            get_next=_GET_NEXT(self.__get_next),
+            get_last_error=_GET_LAST_ERROR(lambda stream: None),
+            release=_RELEASE_STREAM(lambda stream: None),
+        )
+
+
+    def __get_schema(self, stream, out):
+        out[0] = self.schema
+        return 0
+
+
+    def __get_next(self, stream, out):
+        # Keep the current batch alive while its array is used.
+        self.last = next(self.batches, None)
+        out[0] = _Array() if self.last is None else self.last.array
+        return 0
+
+
+    def __arrow_c_stream__(self, requested_schema=None):
+        return _capsule_new(ctypes.addressof(self.stream), _STREAM_NAME, None)
+
+
+def _strings(format, strs, valid=None, offset=0):
+    data = "".join( s or "" for s in strs ).encode()
+    lengths = [ len((s or "").encode()) for s in strs ]
+    offsets = np.cumsum([0] + lengths).astype("i4" if format == "u" else "i8")
+    return Producer(
+        format, len(strs) - offset,
+        [None if valid is None else _validity(valid), offsets,
+         np.frombuffer(data, dtype="u1") if len(data) > 0 else np.zeros(1)],
+        null_count=0 if valid is None else len(valid) - sum(valid),
+        offset=offset)
+
+
+def _format_column(arr, **kw_args):
+    tbl = Table()
+    tbl.add_column("x", arr, **kw_args)
+    tbl.finish()
+    return list(tbl.format())[2 :]
+
+
+#-------------------------------------------------------------------------------
+
+def test_primitive():
+    vals = np.array([3, -1, 400, 7, 12])
+    valid = [True, True, False, True, True]
+    arr = Producer("l", 4, [_validity(valid), vals], null_count=1, offset=1)
+    # The same as a masked array, skipping the offset.
+    assert _format_column(arr) == _format_column(
+        np.ma.masked_array(vals[1 :], mask=[False, True, False, False]))
+    assert _format_column(arr) == ["  -1", "<NA>", "   7", "  12"]
+
+    vals = np.array([0.5, 1.25, -2.0], dtype="float32")
+    assert _format_column(Producer("f", 3, [None, vals])) == _format_column(
+        vals)
+
+
+def test_views():
+    vals = np.arange(10, dtype="int16")
+    arr = ArrowArray(Producer("s", 8, [None, vals], offset=2))
+    assert arr.dtype == np.dtype("int16")
+    assert arr.mask is None
+    assert list(arr.values) == list(range(2, 10))
+    # The values aren't copied.
+    vals[5] = 99
+    assert arr.values[3] == 99
+
+
+def test_bool():
+    bits = _validity([True, False, False, True, True])
+    valid = _validity([True, True, True, False, True])
+    arr = Producer("b", 5, [valid, bits], null_count=1)
+    assert _format_column(arr) == [
+        "true ", "false", "false", "<NA> ", "true "]
+
+
+@pytest.mark.parametrize("format", ["u", "U"])
+def test_strings(format):
+    strs = ["skip", "apple", None, "", "éclair", "banana split"]
+    arr = _strings(format, strs, [s is not None for s in strs], offset=1)
+    assert ArrowArray(arr).max_length == 12
+    assert _format_column(arr) == [
+        "apple       ",
+        "<NA>        ",
+        "            ",
+        "éclair      ",
+        "banana split",
+    ]
+
+
+def test_dictionary():
+    dictionary = _strings("u", ["red", "green", "blue"])
+    codes = np.array([2, 0, 0, 1, 2, 1], dtype="int8")
+    valid = [True, True, False, True, True, True]
+    arr = Producer(
+        "c", 6, [_validity(valid), codes], null_count=1, dictionary=dictionary)
+    assert _format_column(arr) == [
+        "blue ", "red  ", "<NA> ", "green", "blue ", "green"]
+
+
+def test_temporal():
+    ticks = np.array([0, 86400 * 365 + 3600, 1700000000])
+    arr = Producer("tss:", 3, [None, ticks])
+    assert _format_column(arr) == _format_column(ticks.astype("M8[s]"))
+    # The zone of an Arrow timestamp is used.
+    arr = Producer("tsm:+05:30", 3, [None, ticks * 1000])
+    assert _format_column(arr) == _format_column(
+        ticks.astype("M8[s]"), tz=19800)
+
+    arr = Producer("tDs", 3, [None, ticks])
+    assert _format_column(arr) == _format_column(ticks.astype("m8[s]"))
+
+
+def test_native():
+    vals = np.array([1, 22, 333], dtype="int32")
+    # Our producer's capsules don't own it, so keep it alive.
+    producer = Producer("i", 3, [None, vals])
+    tbl = fixfmt._ext.Table()
+    tbl.add_arrow(producer, Number(3))
+    # Also a (schema, array) pair of capsules.
+    tbl.add_arrow(producer.__arrow_c_array__(), Number(3))
+    assert list(tbl.format_rows(0, 3)) == [
+        "   1   1", "  22  22", " 333 333"]
+
+    with pytest.raises(TypeError):
+        # Wrong formatter type.
+        tbl.add_arrow(Producer("i", 3, [None, vals]), fixfmt.String(3))
+    with pytest.raises(TypeError):
+        # Nested types aren't supported.
+        tbl.add_arrow(
+            Producer("+l", 3, [None], children=[Producer("l", 3, [None])]),
+            Number(3))
+    with pytest.raises(TypeError):
+        ArrowArray(Producer("z", 3, [None, None]))
+
+
+def test_chunks():
+    vals = np.array([5, -12, 300, 7, 0, 41])
+    valid = [True, True, True, False, True, True]
+    chunks = [
+        Producer("l", 2, [None, vals[: 2]]),
+        Producer("l", 0, [None, vals[: 0]]),
+        Producer("l", 4, [_validity(valid[2 :]), vals[2 :]], null_count=1),
+    ]
+    arr = ArrowChunks(chunks)
+    assert len(arr) == 6
+    assert list(arr.mask) == [ not v for v in valid ]
+    # The same as concatenating the chunks.
+    assert _format_column(arr) == _format_column(
+        np.ma.masked_array(vals, mask=arr.mask))
+
+    # Dictionary chunks, with their own dictionaries.
+    red = _strings("u", ["red", "green"])
+    blue = _strings("u", ["blue", "turquoise"])
+    chunks = [
+        Producer("c", 2, [None, np.array([1, 0], dtype="i1")], dictionary=red),
+        Producer("c", 2, [None, np.array([0, 1], dtype="i1")], dictionary=blue),
+    ]
+    arr = ArrowChunks(chunks)
+    assert _format_column(arr) == [
+        "green    ", "red      ", "blue     ", "turquoise"]
+
+    with pytest.raises(TypeError):
+        ArrowChunks(chunks + [Producer("l", 1, [None, np.zeros(1, "i8")])])
+
+
+def test_stream_column():
+    vals = np.arange(7, dtype="int32") * 11
+    batches = [
+        Producer("i", 3, [None, vals[: 3]]),
+        Producer("i", 4, [None, vals[3 :]]),
+    ]
+    assert _format_column(StreamProducer(batches)) == _format_column(vals)
+
+
+def _batch(ints, strs):
+    return Producer(
+        "+s", len(ints), [None],
+        children=[
+            Producer("l", len(ints), [None, np.array(ints)], name="num"),
+            _strings("u", strs),
+        ])
+
+
+def test_format_stream():
+    batches = [
+        _batch([1, 22], ["a", "bb"]),
+        _batch([333, 4], ["ccc", "d"]),
+        # Doesn't fit the formatters chosen from the first batch.
+        _batch([55555], ["eeeeee"]),
+    ]
+    lines = list(format_stream(StreamProducer(batches)))
+    assert lines == [
+        "n/ x ", "== ==", " 1 a ", "22 bb", "## c…", " 4 d ", "## e…"]
+
+    # Choosing formatters from all rows gives the same as a single table.
+    cfg = update_cfg(DEFAULT_CFG, {"data": {"analysis_rows": 5}})
+    lines = list(format_stream(StreamProducer(batches), cfg))
+    tbl = Table(cfg)
+    tbl.add_column("num", np.array([1, 22, 333, 4, 55555]))
+    tbl.add_column("x", np.array(["a", "bb", "ccc", "d", "eeeeee"], "O"))
+    tbl.finish()
+    assert lines == list(tbl.format())
+
+    assert list(format_stream(StreamProducer([]))) == []
+
+
+def test_where():
+    from fixfmt.rows import col, where
+    strs = _strings(
+        "u", ["skip", "apple", None, "apricot", "fig"],
+        [True, True, False, True, True], offset=1)
+    vals = np.array([1.5, 2.5, 0.5, -1.0])
+    nums = Producer("g", 4, [_validity([1, 1, 1, 0]), vals], null_count=1)
+    arrs = {"s": strs, "n": nums}
+    assert list(where(arrs, col("s").startswith("ap"))) == [0, 2]
+    assert list(where(arrs, col("s").isnull())) == [1]
+    assert list(where(arrs, col("s") != "fig")) == [0, 2]
+    assert list(where(arrs, col("n") < 2)) == [0, 2]
+    assert list(where(arrs, col("n").isnull())) == [3]
@@ -61,3 +61,27 @@ def test_setters():
         fmt.pos = None
 
 
+def test_bool_bits():
+    np = pytest.importorskip("numpy")
+    from fixfmt._ext import Table
+
+    arr = np.arange(200) % 3 == 0
+    arr[64 : 128] = True
+    fmt = Bool("yes", "no")
+    for bitorder in ("big", "little"):
+        tbl = Table()
+        tbl.add_bool_bits(
+            np.packbits(arr, bitorder=bitorder), len(arr), fmt,
+            bitorder=bitorder)
+        assert len(tbl) == len(arr)
+        assert [ tbl(i) for i in range(len(arr)) ] \
+            == [ fmt(bool(v)) for v in arr ]
+
+    # Bits are little-endian by default, as in Arrow.
+    tbl = Table()
+    tbl.add_bool_bits(
+        np.packbits(arr, bitorder="little"), 100, fmt, offset=50)
+    assert [ tbl(i) for i in range(100) ] \
+        == [ fmt(bool(v)) for v in arr[50 : 150] ]
+
+
@@ -0,0 +1,89 @@
+import pytest
+import numpy as np
+import fixfmt
+import fixfmt._ext
+import fixfmt.npfmt
+import fixfmt.table
+
+NAT = np.timedelta64("NAT")
+
+def test_clock():
+    fmt = fixfmt.TickDuration(scale=1000, precision=3)
+    assert fmt.width == 15
+    assert fmt(0)                   == " 0 00:00:00.000"
+    assert fmt(3723004)             == " 0 01:02:03.004"
+    assert fmt(-3723004)            == "-0 01:02:03.004"
+    assert fmt(90061000)            == " 1 01:01:01.000"
+    assert fmt(10 * 86400000)       == "#" * 15
+
+
+def test_compact():
+    fmt = fixfmt.TickDuration(style="compact", day_digits=2)
+    assert fmt.style == "compact"
+    assert fmt(3)                   == "     3s"
+    assert fmt(123)                 == "  2m03s"
+    assert fmt(3720)                == "  1h02m"
+    assert fmt(-273600)             == " -3d04h"
+    assert fmt(12 * 86400)          == " 12d00h"
+
+
+def test_bad_args():
+    with pytest.raises(ValueError):
+        fixfmt.TickDuration(style="fancy")
+    with pytest.raises(ValueError):
+        fixfmt.TickDuration(precision=19)
+
+
+def test_nat_multibyte():
+    fmt = fixfmt.TickDuration(1, nat="\u2014")
+    nat = NAT.astype("timedelta64[s]").astype(int)
+    assert fmt(nat) == " " * (fmt.width - 1) + "\u2014"
+
+    tbl = fixfmt._ext.Table()
+    tbl.add_tick_duration(np.array([nat, 90]), fmt)
+    assert list(tbl.format_rows(0, 2)) == [fmt(nat), fmt(90)]
+
+
+def test_choose_formatter():
+    arr = np.array([
+        np.timedelta64(1500, "ms"),
+        np.timedelta64(-3, "h"),
+        NAT,
+        np.timedelta64(12, "D"),
+    ]).astype("timedelta64[ns]")
+    fmt = fixfmt.npfmt.choose_formatter(arr)
+    assert fmt.scale == 10 ** 9
+    assert fmt.precision == 1
+    assert fmt.day_digits == 2
+    ticks = arr.view("int64")
+    assert fmt(ticks[0]) == "  0 00:00:01.5"
+    assert fmt(ticks[1]) == " -0 03:00:00.0"
+    assert fmt(ticks[2]) == "           NaT"
+    assert fmt(ticks[3]) == " 12 00:00:00.0"
+
+
+@pytest.mark.parametrize(
+    "base,unit",
+    [("s", "s"), ("m", "m"), ("h", "h"), ("D", "D"), ("W", "W"),
+     ("s", "ms"), ("m", "us"), ("D", "ns")])
+def test_units(base, unit):
+    arr = np.arange(-5, 100, 7).astype(f"timedelta64[{base}]").astype(
+        f"timedelta64[{unit}]")
+    fmt = fixfmt.npfmt.choose_formatter(arr)
+    # Compare with the same durations in seconds.
+    ref = fixfmt.npfmt.choose_formatter(arr.astype("timedelta64[s]"))
+    assert fmt.width == ref.width
+    for t, s in zip(arr.view("int64"), arr.astype("timedelta64[s]").view("int64")):
+        assert fmt(t) == ref(s)
+
+
+def test_table():
+    tbl = fixfmt.table.Table()
+    tbl.add_column("latency", np.array([1, 90, 3600, -7], dtype="timedelta64[s]"))
+    tbl.finish()
+    assert [ l.strip() for l in tbl.format() ][2:] == [
+        "0 00:00:01",
+        "0 00:01:30",
+        "0 01:00:00",
+        "-0 00:00:07",
+    ]
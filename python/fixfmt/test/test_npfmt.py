@@ -30,6 +30,40 @@ def test_choose_formatter_float0():
     assert fmt.precision == 2
 
 
+@skip_np
+def test_choose_formatter_datetime_nat():
+    # NaT doesn't affect the precision.
+    arr = np.array(
+        ["1969-12-31T23:59:59.5", "NaT", "2018-01-18"], dtype="datetime64[ns]")
+    fmt = fixfmt.npfmt.choose_formatter(arr)
+    assert fmt.precision == 1
+
+    arr = np.array(["NaT", "2018-01-18"], dtype="datetime64[ns]")
+    fmt = fixfmt.npfmt.choose_formatter(arr)
+    assert fmt.precision == -1
+
+    cfg = dict(fixfmt.npfmt.DEFAULT_CFG["time"], min_precision=3)
+    fmt = fixfmt.npfmt.choose_formatter_datetime64(arr, cfg=cfg)
+    assert fmt.precision == 3
+
+
+@skip_np
+def test_analyze_ticks():
+    nat = np.iinfo("int64").min
+    arr = np.array([-1230, 45600, nat, 7000], dtype="int64")
+    assert fixfmt._ext.analyze_ticks(arr, 10000, 4) == (
+        True, 3, -1230, 45600, 3)
+    assert fixfmt._ext.analyze_ticks(arr, 10000, 2) == (
+        True, 3, -1230, 45600, 2)
+    assert fixfmt._ext.analyze_ticks(arr, 1, 9) == (
+        True, 3, -1230, 45600, 0)
+    arr = np.array([nat], dtype="int64")
+    has_nat, num, _, _, precision = fixfmt._ext.analyze_ticks(arr, 1000, 9)
+    assert has_nat and num == 0 and precision == 0
+    with pytest.raises(ValueError):
+        fixfmt._ext.analyze_ticks(arr, 1024, 9)
+
+
 @skip_np
 def test_choose_formatter_float1():
     arr = np.arange(1001) / 100000
@@ -99,6 +133,30 @@ def test_choose_formatter_date():
     assert isinstance(fmt, fixfmt.TickDate)
     assert fmt(t0.astype(int)) == "2018-01-01"
     assert fmt.width == len(fmt(t1.astype(int)))
+    assert fmt.min_val == t0.astype(int)
+    assert fmt.max_val == t1.astype(int) - 1
+    assert fmt(t1.astype(int)) == "2019-01-01"
+
+
+@skip_np
+def test_choose_formatter_date_nat():
+    arr = np.array(["2020-02-28", "NaT", "2020-03-01"], dtype="datetime64[D]")
+    fmt = fixfmt.npfmt.choose_formatter(arr)
+    assert fmt.min_val == arr[0].astype(int)
+    assert fmt.max_val == arr[2].astype(int)
+    assert [ fmt(d) for d in arr.astype(int) ] == [
+        "2020-02-28", "NaT       ", "2020-03-01"]
+    for unit, nat in ("W", "NaT       "), ("M", "NaT    "), ("Y", "NaT "):
+        fmt = fixfmt.npfmt.choose_formatter(arr.astype(f"M8[{unit}]"))
+        assert fmt(np.datetime64("NaT").astype(int)) == nat
+
+    arr = np.array(["NaT"], dtype="datetime64[D]")
+    fmt = fixfmt.npfmt.choose_formatter(arr)
+    assert fmt.min_val is None
+    assert repr(fmt) == "TickDate(unit='D')"
+    fmt = fixfmt.TickDate(unit="M", nat="-")
+    assert fmt.nat == "-      "
+    assert repr(fmt) == "TickDate(unit='M', nat=\"-      \")"
 
 
 @skip_np
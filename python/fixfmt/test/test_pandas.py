@@ -0,0 +1,66 @@
+import datetime
+import numpy as np
+import pytest
+
+pd = pytest.importorskip("pandas")
+
+import fixfmt.pandas
+import fixfmt.table
+
+#-------------------------------------------------------------------------------
+
+def format_dataframe(df):
+    tbl = fixfmt.pandas.from_dataframe(df, fixfmt.table.DEFAULT_CFG)
+    return list(tbl.format())
+
+
+def test_categorical():
+    df = pd.DataFrame({
+        "x": pd.Categorical(["a", "bb", None, "a"]),
+        "y": [1, 2, 3, 4],
+    })
+    assert format_dataframe(df)[2:] == [
+        "0 | a  1",
+        "1 | bb 2",
+        "2 |    3",
+        "3 | a  4",
+    ]
+
+
+def test_multiindex():
+    df = pd.DataFrame({"y": [1, 2, 3, 4]})
+    df.index = pd.MultiIndex.from_arrays(
+        [["p", "q", "p", "q"], [10, 10, 20, 20]], names=["k", "j"])
+    assert format_dataframe(df)[2:] == [
+        "p 10 | 1",
+        "q 10 | 2",
+        "p 20 | 3",
+        "q 20 | 4",
+    ]
+
+
+def test_tz_aware():
+    times = pd.date_range("2020-03-08T06:00", periods=3, freq="h", tz="UTC")
+    ist = datetime.timezone(datetime.timedelta(hours=5, minutes=30))
+    df = pd.DataFrame({
+        "ny": times.tz_convert("America/New_York"),
+        "fixed": times.tz_convert(ist),
+    })
+    assert [ l.split()[2:] for l in format_dataframe(df)[2:] ] == [
+        ["2020-03-08T01:00:00-05:00", "2020-03-08T11:30:00+05:30"],
+        ["2020-03-08T03:00:00-04:00", "2020-03-08T12:30:00+05:30"],
+        ["2020-03-08T04:00:00-04:00", "2020-03-08T13:30:00+05:30"],
+    ]
+
+
+def test_nullable():
+    df = pd.DataFrame({
+        "i": pd.array([1, None, -30], dtype="Int64"),
+        "f": pd.array([0.5, 1.25, None], dtype="Float64"),
+        "b": pd.array([None, True, False], dtype="boolean"),
+    })
+    assert format_dataframe(df)[2:] == [
+        "0 |    1 0.50 <NA> ",
+        "1 | <NA> 1.25 true ",
+        "2 |  -30 <NA> false",
+    ]
@@ -0,0 +1,203 @@
+import numpy as np
+import pytest
+
+import fixfmt
+import fixfmt._ext
+from   fixfmt.rows import argsort, col, where
+from   fixfmt.table import Table
+
+#-------------------------------------------------------------------------------
+
+def test_argsort():
+    vals = np.array([5, -2, 7, 5, 0, 3])
+    assert list(argsort(vals)) == list(np.argsort(vals, kind="stable"))
+    assert list(argsort(vals, descending=True)) == [2, 0, 3, 5, 4, 1]
+    # Top N.
+    assert list(argsort(vals, descending=True, limit=2)) == [2, 0]
+    assert list(argsort(vals, limit=100)) == list(argsort(vals))
+    assert list(argsort(vals, limit=0)) == []
+
+
+def test_argsort_keys():
+    a = np.array(["b", "a", "b", "a", "c"], dtype=object)
+    b = np.array([1.5, np.nan, -1.0, 2.5, 0.0])
+    assert list(argsort([a, b])) == [3, 1, 2, 0, 4]
+    assert list(argsort([a, b], descending=[False, True])) == [3, 1, 0, 2, 4]
+    # NaNs are last either way.
+    assert list(argsort(b, descending=True)) == [3, 0, 4, 2, 1]
+
+    t = np.array(["2020-01-03", "2020-01-01", "2020-01-02"], dtype="M8[D]")
+    assert list(argsort(t)) == [1, 2, 0]
+    assert list(argsort(np.array([True, False, True]))) == [1, 0, 2]
+
+
+def test_argsort_masked():
+    vals = np.ma.masked_array([4, 1, 3, 2], mask=[False, True, False, False])
+    # Nulls are last either way.
+    assert list(argsort(vals)) == [3, 2, 0, 1]
+    assert list(argsort(vals, descending=True)) == [0, 2, 3, 1]
+
+
+def test_argsort_nulls():
+    # None and NaT are last either way, like nulls.
+    objs = np.array(["b", None, "a", None, "c"], dtype=object)
+    assert list(argsort(objs)) == [2, 0, 4, 1, 3]
+    assert list(argsort(objs, descending=True)) == [4, 0, 2, 1, 3]
+    t = np.array(["2020-01-03", "NaT", "2020-01-01"], dtype="M8[D]")
+    assert list(argsort(t)) == [2, 0, 1]
+    assert list(argsort(t, descending=True)) == [0, 2, 1]
+    d = np.array([3, "NaT", -1], dtype="m8[s]")
+    assert list(argsort(d)) == [2, 0, 1]
+    vals = np.ma.masked_array(t, mask=[False, False, True])
+    assert list(argsort(vals)) == [0, 1, 2]
+
+
+def test_argsort_errors():
+    with pytest.raises(ValueError):
+        argsort([np.arange(3), np.arange(4)])
+    with pytest.raises(ValueError):
+        argsort([np.arange(3)], descending=[True, False])
+    with pytest.raises(TypeError):
+        argsort(np.zeros(3, dtype=complex))
+
+
+def _format(arrs, rows=None):
+    tbl = Table()
+    for name, arr in arrs.items():
+        tbl.add_column(name, arr)
+    tbl.finish()
+    tbl.select(rows)
+    return list(tbl.format())
+
+
+def test_select():
+    arrs = {
+        "x": np.array([3, 10, 7, 1]),
+        "y": np.array(["c", "a", "b", "d"], dtype=object),
+    }
+    rows = argsort(arrs["x"], descending=True)
+    # The same as formatting the reordered arrays, though the formatters are
+    # chosen from all rows.
+    assert _format(arrs, rows) == _format(
+        { n: a[rows] for n, a in arrs.items() })
+    assert _format(arrs, [1, 1]) == [" x y", "== =", "10 a", "10 a"]
+    assert _format(arrs, []) == [" x y", "== ="]
+    assert _format(arrs, None) == _format(arrs)
+
+    with pytest.raises(IndexError):
+        _format(arrs, [4])
+    with pytest.raises(IndexError):
+        _format(arrs, [-1])
+
+    # A column added after selecting must have the selected rows.
+    tbl = fixfmt._ext.Table()
+    tbl.add_int64(np.arange(3), fixfmt.Number(1))
+    tbl.select(np.array([2]))
+    with pytest.raises(IndexError):
+        tbl.add_int64(np.arange(1), fixfmt.Number(1))
+    tbl.add_int64(np.arange(5), fixfmt.Number(1))
+    assert list(tbl.format_rows(0, 1)) == [" 2 2"]
+
+    # Rows must be int64.
+    for rows in np.array([0.0]), np.array([0], dtype="u8"):
+        with pytest.raises(TypeError):
+            tbl.select(rows)
+
+
+#-------------------------------------------------------------------------------
+
+def _where(arrs, expr):
+    return list(where(arrs, expr))
+
+
+def test_where():
+    arrs = {
+        "x": np.array([5, -2, 7, 5, 0, 3]),
+        "y": np.array([0.5, np.nan, 2.0, -1.0, 8.0, 2.0]),
+        "b": np.array([True, False, True, True, False, False]),
+    }
+    assert _where(arrs, col("x") > 3) == [0, 2, 3]
+    assert _where(arrs, col("x") == 5) == [0, 3]
+    assert _where(arrs, col("x") <= 0) == [1, 4]
+    assert _where(arrs, col("x").between(0, 5)) == [0, 3, 4, 5]
+    # Compared as doubles.
+    assert _where(arrs, col("x") < 2.5) == [1, 4]
+    # NaNs don't match comparisons.
+    assert _where(arrs, col("y") != 2) == [0, 3, 4]
+    assert _where(arrs, col("y").isnull()) == [1]
+    assert _where(arrs, col("y").notnull()) == [0, 2, 3, 4, 5]
+    assert _where(arrs, col("b")) == [0, 2, 3]
+    assert _where(arrs, col("b") & (col("x") > 5) | (col("y") > 5)) == [2, 4]
+    assert _where(arrs, ~col("b") & (col("y") >= 2)) == [4, 5]
+
+    with pytest.raises(KeyError):
+        where(arrs, col("z") > 0)
+    with pytest.raises(TypeError):
+        where(arrs, col("x"))
+    with pytest.raises(TypeError):
+        where(arrs, col("x") > "foo")
+    # Too big to compare as int64.
+    with pytest.raises(ValueError):
+        where(arrs, col("x") < 2**70)
+    with pytest.raises(ValueError):
+        where(arrs, col("x").between(-2**70, 0))
+    assert _where(arrs, col("y") < 2**70) == [0, 2, 3, 4, 5]
+
+    # Compared as uint64.
+    arrs = {"a": np.array([1, 2**63 + 5, 2**64 - 1], dtype="u8")}
+    assert _where(arrs, col("a") > 10) == [1, 2]
+    assert _where(arrs, col("a") == 2**64 - 1) == [2]
+    assert _where(arrs, col("a").between(2**63, 2**64 - 2)) == [1]
+    with pytest.raises(ValueError):
+        where(arrs, col("a") > -1)
+    with pytest.raises(ValueError):
+        where(arrs, col("a") < 2**64)
+
+
+def test_where_masked():
+    arrs = {
+        "x": np.ma.masked_array([1, 2, 3, 4], mask=[False, True, False, True]),
+        "t": np.array(
+            ["2020-01-01", "NaT", "2021-06-30", "2019-12-31"], dtype="M8[D]"),
+    }
+    assert _where(arrs, col("x") > 0) == [0, 2]
+    assert _where(arrs, col("x").isnull()) == [1, 3]
+    assert _where(arrs, col("t") >= np.datetime64("2020-01-01")) == [0, 2]
+    assert _where(arrs, col("t") < "2020-06-01") == [0, 3]
+    assert _where(arrs, col("t").isnull() | col("x").isnull()) == [1, 3]
+
+
+def test_where_strings():
+    strs = ["apple", "banana", None, "apricot", "cherry", "apple"]
+    arrs = {
+        "o": np.array(strs, dtype=object),
+        "u": np.array([ s or "" for s in strs ]),
+    }
+    assert _where(arrs, col("o").startswith("ap")) == [0, 3, 5]
+    assert _where(arrs, col("o").endswith("y")) == [4]
+    assert _where(arrs, col("o").contains("an")) == [1]
+    assert _where(arrs, col("o") == "apple") == [0, 5]
+    # Nulls don't match.
+    assert _where(arrs, col("o") != "apple") == [1, 3, 4]
+    assert _where(arrs, col("o").contains("")) == [0, 1, 3, 4, 5]
+    assert _where(arrs, col("o").isnull()) == [2]
+    assert _where(arrs, col("u").startswith("ap")) == [0, 3, 5]
+    with pytest.raises(TypeError):
+        where(arrs, col("o") < "b")
+
+
+def test_where_select():
+    arrs = {
+        "x": np.arange(100000),
+        "s": np.array([ f"s{i % 1000}" for i in range(100000) ], dtype=object),
+    }
+    rows = where(arrs, (col("x") > 99990) & col("s").endswith("5"))
+    assert list(rows) == [99995]
+    tbl = Table()
+    for name, arr in arrs.items():
+        tbl.add_column(name, arr)
+    tbl.finish()
+    tbl.select(rows)
+    assert list(tbl.format())[2 :] == ["99995 s995"]
+
+
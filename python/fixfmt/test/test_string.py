@@ -1,3 +1,6 @@
+import enum
+import pytest
+
 from   fixfmt import String
 
 #-------------------------------------------------------------------------------
@@ -59,3 +62,51 @@ def test_setters():
     assert fmt("Hello, world!") ==  "::, world!"
 
 
+def test_str_arena():
+    np = pytest.importorskip("numpy")
+    from fixfmt._ext import StrArena, Table
+
+    strs = StrArena(np.array(["foo", 12345, "xü§", None], dtype=object))
+    assert len(strs) == 4
+    assert strs.max_length == 5
+    assert strs.max_size == 5
+    assert not strs.all_ascii
+
+    strs = StrArena(np.array(["ab", "\x1b[1mcd\x1b[m"], dtype=object))
+    assert strs.max_length == 2
+    assert strs.all_ascii
+
+    # A str subclass is converted with its own str().
+    class Color(str, enum.Enum):
+        RED = "red"
+
+    for intern in False, True:
+        strs = StrArena(np.array([Color.RED], dtype=object), intern=intern)
+        assert strs.max_length == 9
+        tbl = Table()
+        tbl.add_str_arena(strs, String(9))
+        assert list(tbl.format_rows(0, 1)) == ["Color.RED"]
+
+
+def test_str_arena_intern():
+    np = pytest.importorskip("numpy")
+    from fixfmt._ext import StrArena
+
+    arr = np.array(["IBM", "MSFT", "IBM", 42, "MSFT", "IBM", 42], dtype=object)
+    strs = StrArena(arr, intern=True)
+    assert strs.interned
+    assert len(strs) == 7
+    assert strs.num_entries == 3
+    assert strs.dedupe_ratio == 7 / 3
+    assert strs.max_length == 4
+
+    arr = np.array([b"XNYS", b"ARCX", b"XNYS", b"XNYS"])
+    strs = StrArena(arr, intern=True)
+    assert strs.num_entries == 2
+    assert strs.dedupe_ratio == 2
+
+    strs = StrArena(arr)
+    assert not strs.interned
+    assert strs.num_entries == 4
+
+
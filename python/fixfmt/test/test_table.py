@@ -1,6 +1,9 @@
+import pytest
 import numpy as np
 
-from   fixfmt.table import Table
+import fixfmt
+import fixfmt._ext
+from   fixfmt.table import Table, DEFAULT_CFG, update_cfg
 
 #-------------------------------------------------------------------------------
 
@@ -32,3 +35,428 @@ def test_array_dtypes():
     tbl.print()
 
 
+def test_categorical():
+    categories = np.array(["foo", "bar", "pineapple"], dtype=object)
+    codes = np.array([0, 2, 1, -1, 2, 0], dtype="int8")
+
+    tbl = Table()
+    tbl.add_column("fruit", categories, codes=codes)
+    tbl.add_column("val", np.arange(6))
+    tbl.finish()
+    lines = list(tbl.format())
+    assert lines[2:] == [
+        "foo       0",
+        "pineapple 1",
+        "bar       2",
+        "          3",
+        "pineapple 4",
+        "foo       5",
+    ]
+
+    # Unsigned codes past the signed range aren't missing.
+    categories = np.array([ f"c{i}" for i in range(300) ], dtype=object)
+    for dtype in "uint8", "uint16", "uint32", "uint64":
+        codes = np.array([0, 128, 255], dtype=dtype)
+        tbl = Table()
+        tbl.add_column("c", categories, codes=codes)
+        tbl.finish()
+        assert list(tbl.format())[2:] == ["c0  ", "c128", "c255"]
+
+
+def test_datetime_units():
+    tbl = Table()
+    tbl.add_column("m", np.array([0, 61], dtype="datetime64[m]"))
+    tbl.add_column("M", np.array([0, 13], dtype="datetime64[M]"))
+    tbl.add_column("ps", np.array([0, 1000], dtype="datetime64[ps]"))
+    tbl.finish()
+    assert [ l.split() for l in tbl.format() ][2:] == [
+        [
+            "1970-01-01T00:00:00+00:00",
+            "1970-01",
+            "1970-01-01T00:00:00.000000000+00:00",
+        ],
+        [
+            "1970-01-01T01:01:00+00:00",
+            "1971-02",
+            "1970-01-01T00:00:00.000000001+00:00",
+        ],
+    ]
+
+
+def test_object_column():
+    arr = np.array(["foo", 42, "xü§", None, "toolongvalue"], dtype=object)
+    tbl = Table()
+    tbl.add_column(
+        "obj", arr, fmt=fixfmt.String(6, pad_pos=0.5))
+    tbl.finish()
+    assert list(tbl.format())[2:] == [
+        "  foo ",
+        "  42  ",
+        "  xü§ ",
+        " None ",
+        "toolo…",
+    ]
+
+
+def test_interned_columns():
+    syms = np.array(["IBM", "MSFT", "IBM", None, "MSFT"], dtype=object)
+    venues = np.array([b"XNYS", b"ARCX", b"XNYS", b"XNYS", b"ARCX"])
+    tbl = Table()
+    tbl.add_column("sym", syms)
+    tbl.add_column("venue", venues)
+    tbl.finish()
+    assert list(tbl.format())[2:] == [
+        "IBM  XNYS",
+        "MSFT ARCX",
+        "IBM  XNYS",
+        "None XNYS",
+        "MSFT ARCX",
+    ]
+
+
+def test_format_rows():
+    arr = np.arange(5000) * 3 - 7
+    tbl = fixfmt._ext.Table()
+    tbl.add_string("[")
+    tbl.add_int64(arr, fixfmt.Number(5))
+    tbl.add_string("|")
+    tbl.add_bool(arr % 2 == 0, fixfmt.Bool())
+    tbl.add_string("]")
+    rows = tbl.format_rows(10, 4000)
+    assert len(rows) == 3990
+    assert rows == [ tbl(i) for i in range(10, 4000) ]
+    assert rows[0] == "[    23|false]"
+    assert tbl.format_rows(7, 7) == []
+    with pytest.raises(IndexError):
+        tbl.format_rows(-1, 3)
+    with pytest.raises(IndexError):
+        tbl.format_rows(3, 2)
+    with pytest.raises(IndexError):
+        tbl.format_rows(0, 5001)
+
+
+def test_format_rows_threads():
+    arr = np.arange(100000) * 7 - 3
+    tbl = fixfmt._ext.Table()
+    tbl.add_int64(arr, fixfmt.Number(7))
+    tbl.add_string(" ")
+    tbl.add_float64(arr / 8, fixfmt.Number(7, 3))
+    serial = tbl.format_rows(5, 99990)
+    for num_threads in (0, 2, 5):
+        assert tbl.format_rows(
+            5, 99990, num_threads=num_threads, block_size=1000) == serial
+    with pytest.raises(ValueError):
+        tbl.format_rows(0, 10, num_threads=-1)
+    with pytest.raises(ValueError):
+        tbl.format_rows(0, 10, num_threads=2, block_size=0)
+
+
+def test_table_threads():
+    arr = np.arange(1000)
+    cfg = fixfmt.table.update_cfg(fixfmt.table.DEFAULT_CFG, {
+        "data": {"max_rows": None, "num_threads": 3, "block_size": 64}
+    })
+    tbl = Table(cfg)
+    tbl.add_column("x", arr)
+    tbl.add_column("s", np.array([ str(i) for i in arr ], dtype=object))
+    tbl.finish()
+    lines = list(tbl.format())
+    assert [ l.split() for l in lines[2:] ] == [ [str(i), str(i)] for i in arr ]
+
+
+def _format_column(arr):
+    tbl = Table()
+    tbl.add_column("x", arr)
+    tbl.finish()
+    return list(tbl.format())
+
+
+@pytest.mark.parametrize(
+    "arr",
+    [
+        np.arange(40, dtype="int16") * 3 - 11,
+        np.arange(40) / 8 - 2,
+        (np.arange(40) / 3).astype("float32"),
+        np.arange(40) % 3 == 0,
+        (np.arange(40) * 123456789).astype("datetime64[ms]"),
+        np.arange(40).astype("timedelta64[s]") * 4567,
+        np.array([ f"s{i * i}" for i in range(40) ]),
+        np.array([ f"b{i * i}".encode() for i in range(40) ]),
+        np.array([ f"o{i * i}" for i in range(40) ], dtype=object),
+    ]
+)
+def test_strided(arr):
+    expected = _format_column(arr[::2].copy())
+    # A slice with a step.
+    assert _format_column(arr[::2]) == expected
+    # Reversed, with a negative stride.
+    assert _format_column(arr[::-2]) == _format_column(arr[::-2].copy())
+    # A column of a 2-D array.
+    arr2 = np.stack([arr[::2], arr[1::2], arr[::2]], axis=1)
+    assert not arr2[:, 2].flags.contiguous
+    assert _format_column(arr2[:, 2]) == expected
+
+
+def test_record_fields():
+    # Fields of a packed record array are strided and unaligned.
+    rec = np.zeros(20, dtype=[("a", "i1"), ("b", "f8"), ("c", "M8[s]")])
+    rec["b"] = np.arange(20) / 4
+    rec["c"] = np.arange(20) * 86399
+    assert _format_column(rec["b"]) == _format_column(rec["b"].copy())
+    assert _format_column(rec["c"]) == _format_column(rec["c"].copy())
+
+
+def test_masked():
+    arr = np.ma.masked_array(
+        [1.5, 2.25, 1e9, -3.0], mask=[False, False, True, False])
+    # The masked value is neither shown nor analyzed.
+    assert _format_column(arr)[2:] == [
+        " 1.50",
+        " 2.25",
+        " <NA>",
+        "-3.00",
+    ]
+
+    tbl = Table()
+    tbl.add_column("x", np.array([10, 20, 30]), mask=np.array([1, 0, 0]))
+    tbl.add_column(
+        "t", np.array(["2020-01-01", "NaT", "2020-01-03"], dtype="M8[D]"),
+        mask=[False, True, False])
+    tbl.finish()
+    assert list(tbl.format())[2:] == [
+        "<NA> 2020-01-01",
+        "  20 <NA>      ",
+        "  30 2020-01-03",
+    ]
+
+    with pytest.raises(ValueError):
+        Table().add_column("x", np.arange(3), mask=[True, False])
+    with pytest.raises(TypeError):
+        Table().add_column(
+            "x", np.array(["a", "b"], dtype=object), mask=[True, False])
+
+
+def test_masked_native():
+    tbl = fixfmt._ext.Table()
+    vals = np.arange(10)
+    fmt = fixfmt.Number(2)
+    tbl.add_int64(vals, fmt, mask=vals % 4 == 0, null="-", null_pad_pos=0.0)
+    # Arrow-style validity bitmap, starting at bit 2.
+    valid = np.packbits(np.arange(12) % 2 == 0, bitorder="little")
+    tbl.add_int64(vals, fmt, valid=valid, valid_offset=2, null="?")
+    assert list(tbl.format_rows(0, 4)) == [
+        "  -  0", "  1?  ", "  2  2", "  3?  "]
+
+    with pytest.raises(ValueError):
+        tbl.add_int64(vals, fmt, mask=np.zeros(9, dtype=bool))
+    with pytest.raises(ValueError):
+        tbl.add_int64(vals, fmt, valid=valid[: 1])
+
+
+def test_ellipsis():
+    cfg = update_cfg(DEFAULT_CFG, {
+        "data": {"max_rows": 8},
+        "row_ellipsis": {"position": 0.5},
+    })
+    tbl = Table(cfg)
+    tbl.add_column("x", np.arange(1000))
+    tbl.finish()
+    lines = list(tbl.format())
+    assert lines == [
+        "  x",
+        "===",
+        "  0",
+        "  1",
+        "... skipping 995 rows ...",
+        "997",
+        "998",
+        "999",
+    ]
+    assert tbl.format_text() == "\n".join(lines)
+
+    # The default position leaves rows after the ellipsis.
+    tbl = Table(update_cfg(DEFAULT_CFG, {"data": {"max_rows": 5}}))
+    tbl.add_column("x", np.arange(1000))
+    tbl.finish()
+    assert list(tbl.format()) == [
+        "  x",
+        "===",
+        "  0",
+        "... skipping 998 rows ...",
+        "999",
+    ]
+
+    # All rows fit.
+    tbl = Table(cfg)
+    tbl.add_column("x", np.arange(6))
+    tbl.finish()
+    lines = list(tbl.format())
+    assert len(lines) == 8
+    assert tbl.format_text() == "\n".join(lines)
+
+
+def test_format_visible():
+    tbl = fixfmt._ext.Table()
+    tbl.add_int64(np.arange(10), fixfmt.Number(1))
+    assert fixfmt._ext.get_visible(10, 20, 0.5) == (10, 0)
+    assert fixfmt._ext.get_visible(10, 5, 0.5) == (2, 2)
+    assert tbl.format_visible(2, 2, "--") == [" 0", " 1", "--", " 8", " 9"]
+    assert tbl.format_visible(1, 0, "--", line_end="|") == " 0|--|"
+    assert tbl.format_visible(10, 0, "--", line_end="\n").count("\n") == 10
+    with pytest.raises(IndexError):
+        tbl.format_visible(6, 5, "--")
+
+
+def test_analyze_visible():
+    cfg = update_cfg(DEFAULT_CFG, {
+        "data": {"max_rows": 7, "analyze": "visible"},
+        "row_ellipsis": {"position": 0.5},
+    })
+    vals = np.arange(1000) % 10
+    vals[500] = 123456789
+    strs = np.array(["a"] * 1000, dtype=object)
+    strs[500] = "long string"
+    tbl = Table(cfg)
+    tbl.add_column("x", vals)
+    tbl.add_column("s", strs)
+    tbl.finish()
+    # The wide hidden row doesn't widen the columns.
+    assert [ f.width for f in tbl._get_fmts() ] == [1, 1]
+    assert list(tbl.format()) == [
+        "x s",
+        "= =",
+        "0 a",
+        "1 a",
+        "... skipping 996 rows ...",
+        "8 a",
+        "9 a",
+    ]
+
+    # The selected rows are the visible ones.
+    tbl = Table(cfg)
+    tbl.add_column("x", vals)
+    tbl.add_column("s", strs)
+    tbl.select([500, 0])
+    tbl.finish()
+    assert list(tbl.format()) == [
+        "        x s          ",
+        "========= ===========",
+        "123456789 long string",
+        "        0 a          ",
+    ]
+
+    # Same as analyzing all rows, when all rows are shown.
+    arr = np.ma.masked_array(np.linspace(0, 1, 5), mask=[0, 1, 0, 0, 0])
+    lines = []
+    for analyze in "all", "visible":
+        tbl = Table(update_cfg(cfg, {"data": {"analyze": analyze}}))
+        tbl.add_index_column("i", np.arange(5))
+        tbl.add_column("x", arr)
+        tbl.add_column(
+            "c", np.array(["yes", "no"], dtype=object),
+            codes=np.array([0, 1, 1, 0, -1]))
+        tbl.finish()
+        lines.append(list(tbl.format()))
+    assert lines[0] == lines[1]
+
+    tbl = Table(cfg)
+    tbl.add_column("x", vals)
+    tbl.select([1000])
+    with pytest.raises(IndexError):
+        tbl.format_text()
+
+
+def test_format_page():
+    cfg = update_cfg(DEFAULT_CFG, {"data": {"max_rows": 5}})
+    tbl = Table(cfg)
+    tbl.add_column("x", np.arange(1000))
+    tbl.finish()
+    assert tbl.get_num_pages() == 334
+    assert tbl.get_num_pages(10) == 100
+    assert list(tbl.format_page(0)) == ["  x", "===", "  0", "  1", "  2"]
+    assert list(tbl.format_page(100)) == [
+        "  x", "===", "300", "301", "302"]
+    assert list(tbl.format_page(-1)) == ["  x", "===", "999"]
+    assert list(tbl.format_page(50, 4, repeat_header=False)) == [
+        "200", "201", "202", "203"]
+    with pytest.raises(IndexError):
+        list(tbl.format_page(334))
+
+    # The pages, without repeated headers, are the whole table.
+    cfg = update_cfg(DEFAULT_CFG, {"data": {"max_rows": None}})
+    tbl = Table(cfg)
+    tbl.add_column("x", np.arange(10))
+    tbl.select(np.arange(10)[:: -1])
+    tbl.finish()
+    num_pages = tbl.get_num_pages(3)
+    assert num_pages == 4
+    assert [
+        l for p in range(num_pages)
+        for l in tbl.format_page(p, 3, repeat_header=False)
+    ] == list(tbl.format())
+    with pytest.raises(ValueError):
+        tbl.get_num_pages()
+
+
+def test_format_page_analyze_visible():
+    # Pages choose formatters from all rows, not only those otherwise shown.
+    cfg = update_cfg(DEFAULT_CFG, {
+        "data": {"max_rows": 5, "analyze": "visible"},
+    })
+    tbl = Table(cfg)
+    tbl.add_column("x", np.arange(1000))
+    tbl.finish()
+    assert list(tbl.format_page(250, 2)) == ["  x", "===", "500", "501"]
+
+    # Also after the table is formatted from its visible rows.
+    vals = np.arange(1000) % 10
+    vals[500] = 123456789
+    tbl = Table(cfg)
+    tbl.add_column("x", vals)
+    tbl.select(np.arange(1000)[:: -1])
+    tbl.finish()
+    assert list(tbl.format())[: 3] == ["x", "=", "9"]
+    assert list(tbl.format_page(249, 2)) == [
+        "        x", "=========", "        1", "123456789"]
+    assert list(tbl.format_page(0, 2, repeat_header=False))[2 :] == [
+        "        9", "        8"]
+    assert list(tbl.format())[: 3] == [
+        "        x", "=========", "        9"]
+
+
+def test_escapes():
+    # Escape sequences have no width, so formatted strings may take many
+    # more bytes than their width.
+    strs = np.array([
+        "\x1b[1m" * (i % 40) + "s{}\x1b[0m".format(i) for i in range(3000)
+    ], dtype=object)
+    fmt = fixfmt.String(5)
+    expected = [ fmt(s) for s in strs ]
+
+    tbl = fixfmt._ext.Table()
+    tbl.add_str_object(strs, fmt)
+    assert list(tbl.format_rows(0, len(strs))) == expected
+
+    tbl = fixfmt._ext.Table()
+    tbl.add_str_arena(fixfmt._ext.StrArena(strs), fmt)
+    assert list(tbl.format_rows(0, len(strs), num_threads=4)) == expected
+
+    tbl = fixfmt._ext.Table()
+    utf8 = np.array([ s.encode() for s in strs ])
+    tbl.add_utf8(utf8.dtype.itemsize, utf8, fmt)
+    assert list(tbl.format_rows(0, len(strs), num_threads=4)) == expected
+
+    for analyze in "all", "visible":
+        cfg = update_cfg(DEFAULT_CFG, {
+            "data": {
+                "analyze": analyze, "intern_strings": False, "max_rows": None,
+            },
+            "formatters": {"by_name": {"s": fmt}},
+            "header": {"show": False},
+            "underline": {"show": False},
+        })
+        tbl = Table(cfg)
+        tbl.add_column("s", strs)
+        tbl.finish()
+        assert list(tbl.format()) == expected
+
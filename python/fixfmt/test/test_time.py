@@ -1,6 +1,8 @@
+import pytest
 import numpy as np
 import fixfmt
 import fixfmt.npfmt
+import fixfmt._ext
 
 NAT = np.datetime64("NAT")
 
@@ -13,9 +15,10 @@ def test_nat():
 
     fmt = fixfmt.npfmt.choose_formatter(arr)
     arr = arr.astype(int)
-    assert fmt(arr[0]) == "1973-12-03T10:45:00.000000000+00:00"
-    assert fmt(arr[1]) == "NaT                                "
-    assert fmt(arr[2]) == "2019-11-01T02:37:51.792111990+00:00"
+    # NaT doesn't count toward precision.
+    assert fmt(arr[0]) == "1973-12-03T10:45:00.00000000+00:00"
+    assert fmt(arr[1]) == "NaT                               "
+    assert fmt(arr[2]) == "2019-11-01T02:37:51.79211199+00:00"
 
 
 def test_nat_custom():
@@ -29,7 +32,17 @@ def test_nat_custom():
     assert fmt(arr[0]) == "1973-12-03T10:45:00.000000+00:00"
     assert fmt(arr[1]) == "INVALID                         "
     assert fmt(arr[2]) == "2019-11-01T02:37:51.792112+00:00"
-    
+
+
+def test_nat_multibyte():
+    arr = np.array([0, NAT.astype("datetime64[s]").astype(int), 60])
+    fmt = fixfmt.TickTime(nat="\u2014")
+    assert fmt(arr[1]) == "\u2014" + " " * 24
+
+    tbl = fixfmt._ext.Table()
+    tbl.add_tick_time(arr, fmt)
+    assert list(tbl.format_rows(0, 3)) == [ fmt(a) for a in arr ]
+
 
 def test_early():
     arr = np.array([
@@ -55,3 +68,74 @@ def test_early():
     assert fmt(arr[4]) == "1970-01-01T00:00:00.000000+00:00"
 
 
+@pytest.mark.parametrize(
+    "unit", ["Y", "M", "W", "D", "h", "m", "s", "ms", "us", "ns", "ps", "fs"])
+def test_units(unit):
+    dtype = f"datetime64[{unit}]"
+    arr = np.array([-1000, -1, 0, 1, 1234], dtype=dtype)
+    fmt = fixfmt.npfmt.choose_formatter(arr)
+    ticks = arr.view("int64")
+    for val, tick in zip(arr, ticks):
+        if unit in ("h", "m"):
+            # We always show seconds.
+            val = val.astype("datetime64[s]")
+        expected = str(val)
+        if len(expected) > 10:
+            expected += "+00:00"
+        assert fmt(tick) == expected
+
+
+def test_tz():
+    zoneinfo = pytest.importorskip("zoneinfo")
+    import datetime
+
+    for name in ("America/New_York", "Europe/London", "Australia/Sydney",
+                 "Asia/Kolkata", "America/Sao_Paulo"):
+        fmt = fixfmt.TickTime(tz=name)
+        assert fmt.tz == name
+        tz = zoneinfo.ZoneInfo(name)
+        for t in range(-2000000000, 6000000000, 86400 * 7 + 3607):
+            d = datetime.datetime.fromtimestamp(t, tz)
+            assert fmt(t) == d.isoformat()[:25]
+
+    fmt = fixfmt.TickTime(tz=-12600)
+    assert fmt.tz == "-03:30"
+    assert fmt(0) == "1969-12-31T20:30:00-03:30"
+
+    with pytest.raises(ValueError):
+        fixfmt.TickTime(tz="Nowhere/Special")
+
+
+@pytest.mark.parametrize(
+    "pattern,expected",
+    [
+        ("%Y-%m-%d %H:%M:%S%f",     "2019-11-01 02:37:51.792"),
+        ("%Y-%m-%dT%H:%M:%S%fZ",    "2019-11-01T02:37:51.792Z"),
+        ("%H:%M:%S%f",              "02:37:51.792"),
+        ("%d/%m/%Y %H:%M %z",       "01/11/2019 02:37 +00:00"),
+    ]
+)
+def test_pattern(pattern, expected):
+    arr = np.array(["2019-11-01T02:37:51.792"], dtype="datetime64[ms]")
+    fmt = fixfmt.TickTime(1000, 3, pattern=pattern)
+    assert fmt.pattern == pattern
+    assert fmt.width == len(expected)
+    assert fmt(arr.astype(int)[0]) == expected
+
+
+def test_pattern_table():
+    from fixfmt.table import Table, DEFAULT_CFG, update_cfg
+    cfg = update_cfg(DEFAULT_CFG, {
+        "formatters": {"default": {"time": {"pattern": "%Y-%m-%d %H:%M:%S"}}}
+    })
+    tbl = Table(cfg)
+    tbl.add_column("t", np.array(["2019-11-01T02:37:51"], dtype="datetime64[s]"))
+    tbl.finish()
+    assert [ l.strip() for l in tbl.format() ][2:] == ["2019-11-01 02:37:51"]
+
+
+def test_pattern_invalid():
+    with pytest.raises(ValueError):
+        fixfmt.TickTime(pattern="%Y-%Q")
+    with pytest.raises(ValueError):
+        fixfmt.TickTime(pattern="%H:%M:%")
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fixfmt.hh"
+#include "gtest/gtest.h"
+
+using namespace fixfmt;
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+ArrowArray
+make_array(
+  long const length,
+  std::vector<void const*>& buffers,
+  long const null_count=0,
+  long const offset=0)
+{
+  ArrowArray array = {};
+  array.length = length;
+  array.null_count = null_count;
+  array.offset = offset;
+  array.n_buffers = buffers.size();
+  array.buffers = buffers.data();
+  return array;
+}
+
+}  // anonymous namespace
+
+TEST(Arrow, primitive) {
+  std::vector<int32_t> const vals = {5, -10, 15, 20, 25};
+  // Entry 2 is null.
+  uint8_t const validity = 0b11111011;
+  std::vector<void const*> buffers = {&validity, vals.data()};
+  auto const array = make_array(4, buffers, 1, 1);
+
+  auto const col = make_arrow_nullable(
+    array, make_arrow_primitive_column<int32_t>(array, Number(2)),
+    "-", PAD_POS_RIGHT_JUSTIFY);
+  ASSERT_EQ(4, col->get_length());
+  ASSERT_EQ(3, col->get_width());
+  ASSERT_EQ("-10", (*col)(0));
+  ASSERT_EQ("  -", (*col)(1));
+  ASSERT_EQ(" 20", (*col)(2));
+  ASSERT_EQ(" 25", (*col)(3));
+}
+
+TEST(Arrow, no_nulls) {
+  std::vector<double> const vals = {0.5, 1.5};
+  std::vector<void const*> buffers = {nullptr, vals.data()};
+  auto const array = make_array(2, buffers);
+  ASSERT_EQ(nullptr, get_arrow_validity(array));
+
+  auto const col = make_arrow_nullable(
+    array, make_arrow_primitive_column<double>(array, Number(1, 1)));
+  ASSERT_EQ(" 0.5", (*col)(0));
+  ASSERT_EQ(" 1.5", (*col)(1));
+}
+
+TEST(Arrow, bool) {
+  uint8_t const bits = 0b00001101;
+  std::vector<void const*> buffers = {nullptr, &bits};
+  auto const array = make_array(3, buffers, 0, 1);
+  auto const col = make_arrow_bool_column(array, Bool("yes", "no"));
+  ASSERT_EQ("no ", (*col)(0));
+  ASSERT_EQ("yes", (*col)(1));
+  ASSERT_EQ("yes", (*col)(2));
+}
+
+TEST(Arrow, strings) {
+  std::string const data = "onetwothreefour";
+  std::vector<int64_t> const offsets = {0, 3, 6, 11, 15};
+  std::vector<void const*> buffers = {nullptr, offsets.data(), data.data()};
+  auto const array = make_array(3, buffers, 0, 1);
+
+  ArrowStringColumn<int64_t> const col(array, String(4));
+  ASSERT_EQ(3, col.get_length());
+  ASSERT_EQ(4, col.get_width());
+  ASSERT_EQ("two ", col(0));
+  ASSERT_EQ("thr…", col(1));
+  ASSERT_EQ("four", col(2));
+}
+
@@ -0,0 +1,85 @@
+#include <string>
+#include <vector>
+
+#include "fixfmt.hh"
+#include "gtest/gtest.h"
+
+using namespace fixfmt;
+
+TEST(TickDuration, clock) {
+  TickDuration const fmt(1000, 3);
+  ASSERT_EQ(15, (int) fmt.get_width());
+  ASSERT_EQ(" 0 00:00:00.000", fmt(0));
+  ASSERT_EQ(" 0 00:00:01.500", fmt(1500));
+  ASSERT_EQ("-0 00:00:01.500", fmt(-1500));
+  ASSERT_EQ(" 1 02:03:04.005", fmt(((26 * 60 + 3) * 60 + 4) * 1000 + 5));
+  ASSERT_EQ("-9 23:59:59.999", fmt(-10l * 86400 * 1000 + 1));
+  ASSERT_EQ("###############", fmt(10l * 86400 * 1000));
+  ASSERT_EQ("            NaT", fmt(TickDuration::NAT_VALUE));
+
+  TickDuration const days(1, TickDuration::PRECISION_NONE,
+                          TickDuration::STYLE_CLOCK, 3);
+  ASSERT_EQ("   0 00:00:00", days(0));
+  ASSERT_EQ("-123 00:00:01", days(-(123l * 86400 + 1)));
+  ASSERT_EQ(" 999 23:59:59", days(1000l * 86400 - 1));
+
+  // Rounding.
+  TickDuration const ms(1000000000, 3);
+  ASSERT_EQ(" 0 00:00:00.002", ms(1500000));
+  ASSERT_EQ("-0 00:00:00.002", ms(-1500000));
+  ASSERT_EQ(" 0 00:00:01.000", ms(999999999));
+}
+
+TEST(TickDuration, compact) {
+  TickDuration const fmt(1000, 3, TickDuration::STYLE_COMPACT, 2);
+  ASSERT_EQ(8, (int) fmt.get_width());
+  ASSERT_EQ("  0.000s", fmt(0));
+  ASSERT_EQ(" -1.500s", fmt(-1500));
+  ASSERT_EQ("-59.999s", fmt(-59999));
+  ASSERT_EQ("   1m00s", fmt(60000));
+  ASSERT_EQ("   1h02m", fmt(3723000));
+  ASSERT_EQ("  -1h02m", fmt(-3723000));
+  ASSERT_EQ("   3d04h", fmt((3 * 24 + 4) * 3600000l));
+  ASSERT_EQ(" -99d23h", fmt(-100 * 86400000l + 1));
+  ASSERT_EQ("########", fmt(100 * 86400000l));
+
+  TickDuration const min(
+    1, TickDuration::PRECISION_NONE, TickDuration::STYLE_COMPACT, 1, "NaT",
+    60);
+  ASSERT_EQ("  2m00s", min(2));
+  ASSERT_EQ("  1h01m", min(61));
+}
+
+TEST(TickDuration, batch) {
+  TickDuration const fmt(1000000, 6);
+  std::vector<long> vals = {0, -1, 86399999999, TickDuration::NAT_VALUE};
+  long const num = vals.size();
+  int const width = fmt.get_width();
+  std::vector<char> buf(num * width);
+  std::vector<char*> pos(num);
+  for (long i = 0; i < num; ++i)
+    pos[i] = &buf[i * width];
+  fmt.format(vals.data(), num, pos.data());
+  for (long i = 0; i < num; ++i) {
+    ASSERT_EQ(buf.data() + (i + 1) * width, pos[i]);
+    ASSERT_EQ(fmt(vals[i]), std::string(&buf[i * width], width));
+  }
+}
+
+TEST(TickDuration, multibyte_nat) {
+  TickDuration const fmt(
+    1, TickDuration::PRECISION_NONE, TickDuration::STYLE_CLOCK, 1, "—");
+  std::string const nat = std::string(10, ' ') + "—";
+  ASSERT_EQ(nat, fmt(TickDuration::NAT_VALUE));
+  ASSERT_EQ(nat.size(), fmt.get_max_bytes());
+
+  long const vals[] = {TickDuration::NAT_VALUE, 90};
+  std::vector<char> buf(2 * fmt.get_max_bytes());
+  char* pos[] = {&buf[0], &buf[fmt.get_max_bytes()]};
+  fmt.format(vals, 2, pos);
+  ASSERT_EQ(nat, std::string(&buf[0], pos[0]));
+  ASSERT_EQ(
+    " 0 00:01:30",
+    std::string(&buf[fmt.get_max_bytes()], pos[1]));
+}
+
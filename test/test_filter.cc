@@ -0,0 +1,137 @@
+#include <cmath>
+#include <vector>
+
+#include "fixfmt.hh"
+#include "gtest/gtest.h"
+
+using namespace fixfmt;
+
+namespace {
+
+std::vector<long>
+filter(
+  Predicate const& pred,
+  long const length,
+  long const block_size=FILTER_BLOCK_SIZE)
+{
+  std::vector<long> rows;
+  filter_rows(pred, 0, length, rows, block_size);
+  return rows;
+}
+
+}  // anonymous namespace
+
+TEST(filter_rows, compare) {
+  std::vector<int> const vals = {5, -2, 7, 5, 0, 3};
+  ComparePredicate<int, long> const gt(vals.data(), CompareOp::GT, 3);
+  // Blocks don't change the result.
+  for (long block_size : {1L, 4L, FILTER_BLOCK_SIZE})
+    ASSERT_EQ((std::vector<long>{0, 2, 3}), filter(gt, 6, block_size));
+  ComparePredicate<int, double> const lt(vals.data(), CompareOp::LT, 2.5);
+  ASSERT_EQ((std::vector<long>{1, 4}), filter(lt, 6));
+  RangePredicate<int, long> const range(vals.data(), 0, 5);
+  ASSERT_EQ((std::vector<long>{0, 3, 4, 5}), filter(range, 6));
+
+  // Unsigned values past the signed range.
+  std::vector<uint64_t> const big = {1, (1UL << 63) + 5, ~0UL};
+  ASSERT_EQ(
+    (std::vector<long>{1, 2}),
+    filter(ComparePredicate<uint64_t, unsigned long>(
+      big.data(), CompareOp::GT, 10), 3));
+  ASSERT_EQ(
+    (std::vector<long>{1}),
+    filter(RangePredicate<uint64_t, unsigned long>(
+      big.data(), 1UL << 63, ~0UL - 1), 3));
+}
+
+TEST(filter_rows, nan) {
+  double const nan = std::nan("");
+  std::vector<double> const vals = {1.0, nan, 3.0};
+  ASSERT_EQ(
+    (std::vector<long>{1}), filter(NanPredicate<double>(vals.data()), 3));
+  ASSERT_EQ(
+    (std::vector<long>{0, 1}),
+    filter(ComparePredicate<double, double>(
+      vals.data(), CompareOp::NE, 3.0), 3));
+}
+
+TEST(filter_rows, unaligned) {
+  // Fields of packed records of a char and a double.
+  struct __attribute__((packed)) Record { char c; double d; };
+  double const nan = std::nan("");
+  std::vector<Record> const recs = {{'a', 3.5}, {'b', nan}, {'c', -1.0}};
+  auto const vals = reinterpret_cast<double const*>(&recs[0].c + 1);
+  long const stride = sizeof(Record);
+  ASSERT_EQ(
+    (std::vector<long>{0}),
+    filter(ComparePredicate<double, double>(
+      vals, CompareOp::GT, 0.0, stride), 3));
+  ASSERT_EQ(
+    (std::vector<long>{2}),
+    filter(RangePredicate<double, double>(vals, -2.0, 0.0, stride), 3));
+  ASSERT_EQ(
+    (std::vector<long>{1}), filter(NanPredicate<double>(vals, stride), 3));
+}
+
+TEST(filter_rows, mask) {
+  uint8_t const bytes[] = {0, 1, 1, 0, 2};
+  ASSERT_EQ((std::vector<long>{1, 2, 4}), filter(MaskPredicate(bytes), 5));
+  // Bits 2 through 8 are 1010011.
+  uint8_t const bits[] = {0x96, 0x01};
+  ASSERT_EQ(
+    (std::vector<long>{0, 2, 5, 6}),
+    filter(MaskPredicate(bits, MaskPredicate::BITS, 2), 7));
+}
+
+TEST(filter_rows, strings) {
+  // "apple", "banana", "apricot", "".
+  char const data[] = "applebananaapricot";
+  long const offsets[] = {0, 5, 11, 18, 18};
+  auto const match = [&](StringOp const op, char const* const pattern) {
+    return filter(StringPredicate<long>(offsets, data, op, pattern), 4);
+  };
+  ASSERT_EQ((std::vector<long>{0, 2}), match(StringOp::STARTSWITH, "ap"));
+  ASSERT_EQ((std::vector<long>{1}), match(StringOp::ENDSWITH, "na"));
+  ASSERT_EQ((std::vector<long>{1}), match(StringOp::CONTAINS, "nan"));
+  ASSERT_EQ((std::vector<long>{2}), match(StringOp::EQ, "apricot"));
+  ASSERT_EQ((std::vector<long>{3}), match(StringOp::EQ, ""));
+  ASSERT_EQ(
+    (std::vector<long>{0, 1, 2, 3}), match(StringOp::CONTAINS, ""));
+
+  // Interned: rows are entries by code.
+  unsigned const codes[] = {2, 2, 0, 1, 3};
+  StringPredicate<long> const interned(
+    offsets, data, StringOp::STARTSWITH, "ap", codes, 4);
+  ASSERT_EQ((std::vector<long>{0, 1, 2}), filter(interned, 5));
+}
+
+TEST(filter_rows, combine) {
+  std::vector<long> const vals = {1, 2, 3, 4, 5, 6};
+  auto const gt = [&](long const v) {
+    return std::make_unique<ComparePredicate<long, long>>(
+      vals.data(), CompareOp::GT, v);
+  };
+  auto const lt = [&](long const v) {
+    return std::make_unique<ComparePredicate<long, long>>(
+      vals.data(), CompareOp::LT, v);
+  };
+
+  std::vector<unique_ptr<Predicate>> preds;
+  preds.push_back(gt(1));
+  preds.push_back(lt(5));
+  AllAnyPredicate const all(true, std::move(preds));
+  ASSERT_EQ((std::vector<long>{1, 2, 3}), filter(all, 6));
+
+  preds.clear();
+  preds.push_back(lt(2));
+  preds.push_back(gt(4));
+  AllAnyPredicate const any(false, std::move(preds));
+  ASSERT_EQ((std::vector<long>{0, 4, 5}), filter(any, 6));
+
+  NotPredicate const not_(gt(2));
+  ASSERT_EQ((std::vector<long>{0, 1}), filter(not_, 6));
+
+  // No predicates.
+  ASSERT_EQ(6u, filter(AllAnyPredicate(true, {}), 6).size());
+  ASSERT_EQ(0u, filter(AllAnyPredicate(false, {}), 6).size());
+}
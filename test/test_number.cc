@@ -1,5 +1,6 @@
 #include <cmath>
 #include <cstdlib>
+#include <vector>
 
 #include "fixfmt.hh"
 #include "gtest/gtest.h"
@@ -358,3 +359,36 @@ TEST(Number, scale_special) {
   ASSERT_EQ("-inf   ", fmt(-INFINITY));
 }
 
+TEST(Number, format_batch) {
+  // Batch output matches single values, for integral and floating types,
+  // special values, and multibyte output.
+  std::vector<double> const doubles = {
+    0, -0.5, 1.25, 123.456, -99999.9, 1e9, NAN, INFINITY, -INFINITY };
+  std::vector<int> const ints = { 0, -1, 42, 9999, -10000, 123456 };
+
+  Number::Args args{5, 2};
+  args.nan = "—";
+  for (auto scale : {Number::SCALE_NONE, Number::SCALE_MICRO}) {
+    args.scale = scale;
+    Number const fmt(args);
+    std::vector<char> buf(10 * fmt.get_max_bytes());
+    std::vector<char*> pos(10);
+
+    for (size_t i = 0; i < doubles.size(); ++i)
+      pos[i] = &buf[i * fmt.get_max_bytes()];
+    fmt.format(doubles.data(), doubles.size(), pos.data());
+    for (size_t i = 0; i < doubles.size(); ++i) {
+      char const* const start = &buf[i * fmt.get_max_bytes()];
+      ASSERT_EQ(fmt(doubles[i]), std::string(start, pos[i] - start));
+    }
+
+    for (size_t i = 0; i < ints.size(); ++i)
+      pos[i] = &buf[i * fmt.get_max_bytes()];
+    fmt.format(ints.data(), ints.size(), pos.data());
+    for (size_t i = 0; i < ints.size(); ++i) {
+      char const* const start = &buf[i * fmt.get_max_bytes()];
+      ASSERT_EQ(fmt(ints[i]), std::string(start, pos[i] - start));
+      ASSERT_EQ(fmt((long) ints[i]), fmt(ints[i]));
+    }
+  }
+}
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <vector>
+
+#include "fixfmt.hh"
+#include "gtest/gtest.h"
+
+using namespace fixfmt;
+
+namespace {
+
+template<typename TYPE>
+std::vector<unique_ptr<SortKey>>
+make_keys(
+  std::vector<TYPE> const& vals,
+  bool const descending=false)
+{
+  std::vector<unique_ptr<SortKey>> keys;
+  keys.push_back(std::make_unique<ArraySortKey<TYPE>>(
+    vals.data(), descending));
+  return keys;
+}
+
+}  // anonymous namespace
+
+TEST(argsort, basic) {
+  std::vector<int> const vals = {5, -2, 7, 5, 0};
+  std::vector<long> rows(5);
+  argsort(make_keys(vals), 5, rows.data(), 5);
+  // Stable: ties in row order.
+  ASSERT_EQ((std::vector<long>{1, 4, 0, 3, 2}), rows);
+  argsort(make_keys(vals, true), 5, rows.data(), 5);
+  ASSERT_EQ((std::vector<long>{2, 0, 3, 4, 1}), rows);
+}
+
+TEST(argsort, nan) {
+  double const nan = std::nan("");
+  std::vector<double> const vals = {1.5, nan, -3.0, nan, 8.25};
+  std::vector<long> rows(5);
+  // NaNs are last either way.
+  argsort(make_keys(vals), 5, rows.data(), 5);
+  ASSERT_EQ((std::vector<long>{2, 0, 4, 1, 3}), rows);
+  argsort(make_keys(vals, true), 5, rows.data(), 5);
+  ASSERT_EQ((std::vector<long>{4, 0, 2, 1, 3}), rows);
+}
+
+TEST(argsort, keys) {
+  std::vector<unsigned char> const a = {1, 0, 1, 0, 1, 0};
+  std::vector<long> const b = {3, 3, 1, 9, 2, 3};
+  std::vector<unique_ptr<SortKey>> keys;
+  keys.push_back(std::make_unique<ArraySortKey<unsigned char>>(a.data()));
+  keys.push_back(std::make_unique<ArraySortKey<long>>(b.data(), true));
+  std::vector<long> rows(6);
+  argsort(keys, 6, rows.data(), 6);
+  ASSERT_EQ((std::vector<long>{3, 1, 5, 0, 4, 2}), rows);
+}
+
+TEST(argsort, top) {
+  long const length = 1000;
+  std::vector<long> vals(length);
+  for (long i = 0; i < length; ++i)
+    vals[i] = (i * 7919) % 101;
+  auto const keys = make_keys(vals, true);
+  std::vector<long> all(length);
+  argsort(keys, length, all.data(), length);
+  // The top N are the leading rows of the full sort.
+  for (long num : {0L, 1L, 10L, 999L}) {
+    std::vector<long> rows(num);
+    argsort(keys, length, rows.data(), num);
+    ASSERT_EQ(std::vector<long>(all.begin(), all.begin() + num), rows);
+  }
+}
+
+TEST(argsort, strided) {
+  // Sort by the second field of pairs.
+  std::vector<int> const pairs = {0, 30, 1, 10, 2, 20};
+  std::vector<unique_ptr<SortKey>> keys;
+  keys.push_back(std::make_unique<ArraySortKey<int>>(
+    pairs.data() + 1, false, 2 * sizeof(int)));
+  std::vector<long> rows(3);
+  argsort(keys, 3, rows.data(), 3);
+  ASSERT_EQ((std::vector<long>{1, 2, 0}), rows);
+}
+
+TEST(argsort, unaligned) {
+  // Sort by the double field of packed records of a char and a double.
+  struct __attribute__((packed)) Record { char c; double d; };
+  std::vector<Record> const recs = {{'a', 3.5}, {'b', -1.0}, {'c', 2.0}};
+  std::vector<unique_ptr<SortKey>> keys;
+  keys.push_back(std::make_unique<ArraySortKey<double>>(
+    reinterpret_cast<double const*>(&recs[0].c + 1), false, sizeof(Record)));
+  std::vector<long> rows(3);
+  argsort(keys, 3, rows.data(), 3);
+  ASSERT_EQ((std::vector<long>{1, 2, 0}), rows);
+}
@@ -11,4 +11,16 @@ TEST(String, basic) {
   ASSERT_EQ("Hello, wo\u2026", fmt("Hello, world!"));
 }
 
+TEST(String, get_max_bytes) {
+  String fmt(String::Args{6, "…", "·"});
+  // Escape sequences have no width.
+  std::string const red = "\x1b[31mred\x1b[0m";
+  std::string const bold_red = "\x1b[31m\x1b[1mred!!!\x1b[0m";
+  for (auto const& str : {red, bold_red, std::string("……")}) {
+    auto const result = fmt(str);
+    ASSERT_EQ(6u, string_length(result));
+    ASSERT_LE(result.size(), fmt.get_max_bytes(str.size()));
+  }
+}
+
 // FIXME: More tests.
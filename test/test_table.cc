@@ -0,0 +1,513 @@
+#include <string>
+#include <vector>
+
+#include "fixfmt.hh"
+#include "gtest/gtest.h"
+
+using namespace fixfmt;
+
+TEST(CategoricalColumn, basic) {
+  long const categories[] = {7, 42, 1000};
+  ColumnImpl<long, Number> const cat_col(categories, 3, Number(4));
+  signed char const codes[] = {2, 0, -1, 1, 5};
+  CategoricalColumn<signed char> col(codes, 5, cat_col, "-");
+  ASSERT_EQ(5, col.get_width());
+  ASSERT_EQ(5, col.get_length());
+  ASSERT_EQ(3, col.get_num_categories());
+  ASSERT_EQ(" 1000", col(0));
+  ASSERT_EQ("    7", col(1));
+  ASSERT_EQ("-    ", col(2));
+  ASSERT_EQ("   42", col(3));
+  ASSERT_EQ("-    ", col(4));
+}
+
+TEST(BitBoolColumn, basic) {
+  uint8_t const bits[] = {0x05, 0x80};
+  BitBoolColumn lsb(bits, 0, 16, Bool("yes", "no"));
+  ASSERT_EQ("yes", lsb(0));
+  ASSERT_EQ("no ", lsb(1));
+  ASSERT_EQ("yes", lsb(2));
+  ASSERT_EQ("yes", lsb(15));
+  BitBoolColumn msb(bits, 0, 16, Bool("yes", "no"), false);
+  ASSERT_EQ("no ", msb(0));
+  ASSERT_EQ("yes", msb(5));
+  ASSERT_EQ("yes", msb(7));
+  ASSERT_EQ("yes", msb(8));
+  ASSERT_EQ("no ", msb(15));
+}
+
+TEST(BitBoolColumn, format) {
+  // Some words all false, some all true, and some mixed.
+  std::vector<uint8_t> bits(40, 0);
+  for (size_t i = 8; i < 16; ++i)
+    bits[i] = 0xff;
+  for (size_t i = 16; i < 24; ++i)
+    bits[i] = 0x5a;
+  long const length = 300;
+
+  for (long offset : {0, 3, 8}) {
+    BitBoolColumn col(bits.data(), offset, length, Bool("T", "F"));
+    for (long begin : {0, 1, 5, 64}) {
+      long const end = length;
+      std::vector<char> buf(end - begin);
+      std::vector<char*> pos;
+      for (long i = begin; i < end; ++i)
+        pos.push_back(&buf[i - begin]);
+      col.format(begin, end, pos.data());
+      for (long i = begin; i < end; ++i) {
+        ASSERT_EQ(&buf[i - begin] + 1, pos[i - begin]);
+        ASSERT_EQ(col(i), std::string(1, buf[i - begin]));
+      }
+    }
+  }
+}
+
+TEST(Table, format_row_into) {
+  long const nums[] = {7, -42, 1000};
+  long const times[] = {0, 18000, TickTime::NAT_VALUE};
+  uint8_t const bits[] = {0x05};
+  long const categories[] = {1, 2};
+  ColumnImpl<long, Number> const cat_col(categories, 2, Number(2));
+  signed char const codes[] = {1, -1, 0};
+
+  Table table;
+  table.add_string("| ");
+  table.add_column(
+    unique_ptr<Column>(new ColumnImpl<long, Number>(nums, 3, Number(4))));
+  table.add_string(" │ ");
+  table.add_column(
+    unique_ptr<Column>(new ColumnImpl<long, TickDate>(times, 3, TickDate())));
+  table.add_string(" ");
+  table.add_column(
+    unique_ptr<Column>(new BitBoolColumn(bits, 0, 3, Bool("✓", "-"))));
+  table.add_column(
+    unique_ptr<Column>(
+      new CategoricalColumn<signed char>(codes, 3, cat_col, "?")));
+  ASSERT_EQ(3, table.get_length());
+  ASSERT_EQ(2 + 5 + 3 + 10 + 1 + 1 + 3, table.get_width());
+  // Numbers and dates take a byte per character, and the box character and
+  // check mark three bytes each.
+  ASSERT_EQ(2 + 5 + 5 + 10 + 1 + 3 + 3, table.get_max_bytes());
+
+  std::vector<char> buf(table.get_max_bytes());
+  char* const end = table.format_row_into(1, buf.data());
+  ASSERT_EQ("|   -42 │ 2019-04-14 -?  ", std::string(buf.data(), end));
+  ASSERT_EQ("|     7 │ 1970-01-01 ✓  2", table(0));
+  ASSERT_EQ("|  1000 │ NaT        ✓  1", table(2));
+}
+
+namespace {
+
+class VectorSink
+  : public Sink
+{
+public:
+
+  virtual void 
+  operator()(
+    long const index, 
+    char const* const row, 
+    size_t const size) 
+    override
+  {
+    indices.push_back(index);
+    rows.emplace_back(row, size);
+  }
+
+  std::vector<long> indices;
+  std::vector<std::string> rows;
+
+};
+
+}  // anonymous namespace
+
+TEST(Table, render) {
+  long const length = 2500;
+  std::vector<long> nums(length);
+  std::vector<long> times(length);
+  std::vector<uint8_t> bits((length + 7) / 8);
+  std::vector<signed char> codes(length);
+  for (long i = 0; i < length; ++i) {
+    nums[i] = i * 37 - 5000;
+    times[i] = i % 7 == 0 ? TickTime::NAT_VALUE : i * 86399;
+    bits[i / 8] |= (i % 3 == 0) << (i % 8);
+    codes[i] = i % 4 - 1;
+  }
+  long const categories[] = {1, 2, 3};
+  ColumnImpl<long, Number> const cat_col(categories, 3, Number(1));
+
+  Table table;
+  table.add_string("│");
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<long, Number>(nums.data(), length, Number(6))));
+  table.add_string(" ");
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<long, TickTime>(times.data(), length, TickTime())));
+  table.add_column(unique_ptr<Column>(
+    new BitBoolColumn(bits.data(), 0, length, Bool("✓", "·"))));
+  table.add_column(unique_ptr<Column>(
+    new CategoricalColumn<signed char>(codes.data(), length, cat_col, "?")));
+  table.add_string("│");
+
+  for (long tile_size : {1L, 7L, 1024L, 4096L}) {
+    VectorSink sink;
+    table.render(3, length - 1, sink, tile_size);
+    ASSERT_EQ(length - 4, (long) sink.rows.size());
+    for (long i = 3; i < length - 1; ++i) {
+      ASSERT_EQ(i, sink.indices[i - 3]);
+      ASSERT_EQ(table(i), sink.rows[i - 3]);
+    }
+  }
+
+  VectorSink sink;
+  table.render(5, 5, sink);
+  ASSERT_TRUE(sink.rows.empty());
+}
+
+TEST(Table, render_parallel) {
+  long const length = 10007;
+  std::vector<long> nums(length);
+  std::vector<long> times(length);
+  for (long i = 0; i < length; ++i) {
+    nums[i] = i * 7919 % 100003 - 50000;
+    times[i] = i * 1234567;
+  }
+
+  Table table;
+  table.add_string("│");
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<long, Number>(nums.data(), length, Number(6))));
+  table.add_string(" ");
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<long, TickTime>(times.data(), length, TickTime())));
+  table.add_string("│");
+  ASSERT_TRUE(table.is_thread_safe());
+
+  VectorSink serial;
+  table.render(0, length, serial);
+
+  for (int num_threads : {0, 1, 2, 7}) 
+    for (long block_size : {1L, 100L, 4096L, 100000L})
+      for (int max_blocks : {0, 1, 3}) {
+        if (block_size == 1 && num_threads != 2)
+          continue;
+        VectorSink sink;
+        table.render_parallel(
+          0, length, sink, num_threads, block_size, max_blocks);
+        ASSERT_EQ(serial.indices, sink.indices);
+        ASSERT_EQ(serial.rows, sink.rows);
+      }
+
+  VectorSink part;
+  table.render_parallel(17, 9000, part, 4, 64);
+  ASSERT_EQ(9000 - 17, (long) part.rows.size());
+  ASSERT_EQ(17, part.indices.front());
+  ASSERT_EQ(serial.rows[17], part.rows.front());
+  ASSERT_EQ(serial.rows[8999], part.rows.back());
+}
+
+namespace {
+
+class ThrowingSink
+  : public Sink
+{
+public:
+
+  virtual void 
+  operator()(
+    long const index, 
+    char const* const /* row */, 
+    size_t const /* size */) 
+    override
+  {
+    if (index == 5000)
+      throw std::runtime_error("full");
+  }
+
+};
+
+}  // anonymous namespace
+
+TEST(Table, render_parallel_error) {
+  long const length = 10000;
+  std::vector<long> nums(length, 42);
+  Table table;
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<long, Number>(nums.data(), length, Number(3))));
+  ThrowingSink sink;
+  ASSERT_THROW(table.render_parallel(0, length, sink, 4, 100), std::runtime_error);
+}
+
+namespace {
+
+/*
+ * A column of escape-coded strings, whose bytes aren't bounded up front.
+ */
+class EscapedColumn
+  : public Column
+{
+public:
+
+  EscapedColumn(long const length) : length_(length) {}
+
+  virtual int get_width() const override { return 2; }
+
+  virtual long get_length() const override { return length_; }
+
+  virtual int get_max_bytes() const override { return NO_MAX_BYTES; }
+
+  virtual string
+  operator()(
+    long const index)
+    const override
+  {
+    string result;
+    for (long i = 0; i < index % 50; ++i)
+      result += "\x1b[1m";
+    return result + "ab\x1b[0m";
+  }
+
+private:
+
+  long const length_;
+
+};
+
+}  // anonymous namespace
+
+TEST(Table, escapes) {
+  long const length = 5000;
+  std::unique_ptr<bool[]> vals(new bool[length]);
+  for (long i = 0; i < length; ++i)
+    vals[i] = i % 3 == 0;
+  // The formatted values are much longer than four bytes per character.
+  Bool const fmt("\x1b[32m\x1b[1m\x1b[4my\x1b[0m", "\x1b[31mn\x1b[0m");
+  Table table;
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<bool, Bool>(vals.get(), length, fmt)));
+  ASSERT_EQ(1, table.get_width());
+  ASSERT_EQ((int) fmt.get_true().size(), table.get_max_bytes());
+
+  VectorSink bounded;
+  table.render_parallel(0, length, bounded, 4, 100);
+  ASSERT_EQ(fmt.get_true(), bounded.rows[0]);
+  ASSERT_EQ(fmt.get_false(), bounded.rows[1]);
+
+  table.add_string(" ");
+  table.add_column(unique_ptr<Column>(new EscapedColumn(length)));
+  ASSERT_EQ(Column::NO_MAX_BYTES, table.get_max_bytes());
+  ASSERT_EQ(fmt.get_true() + " ab\x1b[0m", table(0));
+
+  VectorSink serial;
+  table.render(0, length, serial, 7);
+  VectorSink parallel;
+  table.render_parallel(0, length, parallel, 4, 100);
+  ASSERT_EQ(length, (long) serial.rows.size());
+  ASSERT_EQ(serial.rows, parallel.rows);
+  for (long i = 0; i < length; i += 49)
+    ASSERT_EQ(table(i), serial.rows[i]);
+}
+
+TEST(ColumnImpl, strided) {
+  // Column 1 of a 1000 x 3 row-major array.
+  long const length = 1000;
+  std::vector<double> vals(length * 3);
+  for (long i = 0; i < length; ++i) {
+    vals[i * 3] = -1;
+    vals[i * 3 + 1] = i * 0.25;
+    vals[i * 3 + 2] = -2;
+  }
+  ColumnImpl<double, Number> const col(
+    &vals[1], length, Number(3, 2), 3 * sizeof(double));
+  ASSERT_EQ(length, col.get_length());
+  ASSERT_EQ("   0.00", col(0));
+  ASSERT_EQ(" 249.75", col(999));
+
+  // Block formatting gathers the strided values.
+  int const width = col.get_width();
+  std::vector<char> buf(length * width);
+  std::vector<char*> pos(length);
+  for (long i = 0; i < length; ++i)
+    pos[i] = &buf[i * width];
+  col.format(0, length, pos.data());
+  for (long i = 0; i < length; ++i) {
+    ASSERT_EQ(&buf[(i + 1) * width], pos[i]);
+    ASSERT_EQ(col(i), std::string(&buf[i * width], width));
+  }
+
+  // Negative stride.
+  ColumnImpl<double, Number> const rev(
+    &vals[(length - 1) * 3 + 1], length, Number(3, 2), -3 * (long) sizeof(double));
+  ASSERT_EQ(" 249.75", rev(0));
+  ASSERT_EQ("   0.00", rev(999));
+}
+
+TEST(NullableColumn, mask) {
+  // More than one chunk of block formatting.
+  long const length = 1000;
+  std::vector<long> vals(length);
+  // Null bytes and validity bitmap, both starting at offset 3.
+  std::vector<uint8_t> nulls(length + 3, 1);
+  std::vector<uint8_t> valid((length + 3 + 7) / 8);
+  for (long i = 0; i < length; ++i) {
+    vals[i] = i;
+    nulls[i + 3] = i % 3 == 0;
+    if (i % 3 != 0)
+      valid[(i + 3) / 8] |= 1 << ((i + 3) % 8);
+  }
+
+  for (int const kind : {
+      NullableColumn::MASK_NULL_BYTES, NullableColumn::MASK_VALID_BITS}) {
+    auto const mask = 
+      kind == NullableColumn::MASK_NULL_BYTES ? nulls.data() : valid.data();
+    NullableColumn const col(
+      std::make_unique<ColumnImpl<long, Number>>(vals.data(), length, Number(3)),
+      mask, kind, 3, "<NA>", PAD_POS_RIGHT_JUSTIFY);
+    ASSERT_EQ(4, col.get_width());
+    ASSERT_EQ(length, col.get_length());
+    ASSERT_EQ("<NA>", col(0));
+    ASSERT_EQ("   1", col(1));
+    ASSERT_EQ("  98", col(98));
+    ASSERT_EQ("<NA>", col(99));
+
+    // Block formatting overwrites the nulls.
+    int const width = col.get_width();
+    std::vector<char> buf(length * width);
+    std::vector<char*> pos(length);
+    for (long i = 0; i < length; ++i)
+      pos[i] = &buf[i * width];
+    col.format(0, length, pos.data());
+    for (long i = 0; i < length; ++i) {
+      ASSERT_EQ(&buf[(i + 1) * width], pos[i]);
+      ASSERT_EQ(col(i), std::string(&buf[i * width], width));
+    }
+  }
+}
+
+TEST(ChunkedColumn, basic) {
+  std::vector<long> const a = {0, 1, 2};
+  std::vector<long> const b = {};
+  std::vector<long> const c = {3, 4, 5, 6, 7};
+  ChunkedColumn col(3);
+  for (auto const* vals : {&a, &b, &c})
+    col.add_chunk(std::make_unique<ColumnImpl<long, Number>>(
+      vals->data(), vals->size(), Number(2)));
+  ASSERT_EQ(3, col.get_num_chunks());
+  ASSERT_EQ(8, col.get_length());
+  ASSERT_EQ("  0", col(0));
+  ASSERT_EQ("  2", col(2));
+  ASSERT_EQ("  3", col(3));
+  ASSERT_EQ("  7", col(7));
+
+  // Blocks that span chunks.
+  for (long begin = 0; begin < 8; ++begin)
+    for (long end = begin; end <= 8; ++end) {
+      std::vector<char> buf(8 * 3);
+      std::vector<char*> pos(end - begin);
+      for (long i = 0; i < end - begin; ++i)
+        pos[i] = &buf[i * 3];
+      col.format(begin, end, pos.data());
+      for (long i = 0; i < end - begin; ++i) {
+        ASSERT_EQ(&buf[(i + 1) * 3], pos[i]);
+        ASSERT_EQ(col(begin + i), std::string(&buf[i * 3], 3));
+      }
+    }
+}
+
+TEST(Table, select) {
+  long const length = 100;
+  std::vector<long> nums(length);
+  std::vector<uint8_t> bits((length + 7) / 8);
+  for (long i = 0; i < length; ++i) {
+    nums[i] = i * 3;
+    bits[i / 8] |= (i % 3 == 0) << (i % 8);
+  }
+  Table table;
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<long, Number>(nums.data(), length, Number(3))));
+  table.add_string(" ");
+  table.add_column(unique_ptr<Column>(
+    new BitBoolColumn(bits.data(), 0, length, Bool("T", "F"))));
+  std::vector<std::string> all;
+  for (long i = 0; i < length; ++i)
+    all.push_back(table(i));
+
+  // Runs of consecutive rows, reordered rows, and repeats.
+  std::vector<long> const rows = {10, 11, 12, 13, 2, 99, 98, 50, 50, 51, 0};
+  table.select(rows.data(), rows.size());
+  ASSERT_EQ((long) rows.size(), table.get_length());
+  ASSERT_EQ(100, table.get_rows_end());
+  ASSERT_EQ("  30 F", table(0));
+  for (long tile_size : {1L, 3L, 1024L}) {
+    VectorSink sink;
+    table.render(0, rows.size(), sink, tile_size);
+    ASSERT_EQ(rows.size(), sink.rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+      ASSERT_EQ((long) i, sink.indices[i]);
+      ASSERT_EQ(all[rows[i]], sink.rows[i]);
+      ASSERT_EQ(all[rows[i]], table(i));
+    }
+  }
+
+  table.select(nullptr, 0);
+  ASSERT_EQ(length, table.get_length());
+  ASSERT_EQ(0, table.get_rows_end());
+}
+
+TEST(Table, render_visible) {
+  long const length = 100;
+  std::vector<long> nums(length);
+  for (long i = 0; i < length; ++i)
+    nums[i] = i;
+  Table table;
+  table.add_column(unique_ptr<Column>(
+    new ColumnImpl<long, Number>(nums.data(), length, Number(2))));
+
+  auto const visible = table.get_visible(10, 0.7);
+  ASSERT_TRUE(visible.elided);
+  ASSERT_EQ(6, visible.num_top);
+  ASSERT_EQ(3, visible.num_bottom);
+  // Rows on both sides of the ellipsis, however near the end it is.
+  auto const end = table.get_visible(4, 0.85);
+  ASSERT_EQ(2, end.num_top);
+  ASSERT_EQ(1, end.num_bottom);
+  auto const all = table.get_visible(100, 0.7);
+  ASSERT_FALSE(all.elided);
+  ASSERT_EQ(100, all.num_top);
+  ASSERT_EQ(0, all.num_bottom);
+  // Only the ellipsis.
+  auto const none = table.get_visible(1, 0.7);
+  ASSERT_TRUE(none.elided);
+  ASSERT_EQ(0, none.num_top + none.num_bottom);
+
+  class EllipsisSink
+    : public VectorSink
+  {
+  public:
+
+    virtual void
+    ellipsis(
+      char const* const line,
+      size_t const size)
+      override
+    {
+      indices.push_back(-1);
+      rows.emplace_back(line, size);
+    }
+
+  };
+
+  for (int num_threads : {1, 3}) {
+    EllipsisSink sink;
+    table.render_visible(visible, "...", sink, num_threads, 2);
+    ASSERT_EQ(10u, sink.rows.size());
+    for (long i = 0; i < 6; ++i) {
+      ASSERT_EQ(i, sink.indices[i]);
+      ASSERT_EQ(table(i), sink.rows[i]);
+    }
+    ASSERT_EQ(-1, sink.indices[6]);
+    ASSERT_EQ("...", sink.rows[6]);
+    ASSERT_EQ(97, sink.indices[7]);
+    ASSERT_EQ(" 99", sink.rows[9]);
+  }
+}
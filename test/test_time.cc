@@ -0,0 +1,300 @@
+#include <ctime>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "fixfmt.hh"
+#include "gtest/gtest.h"
+
+using namespace fixfmt;
+
+TEST(days_to_civil, gmtime) {
+  // Compare against the C library over the full four-digit year range.
+  for (long days = DAY_MIN; days <= DAY_MAX; days += 97) {
+    time_t const secs = days * 86400;
+    struct tm tm;
+    ASSERT_NE(nullptr, gmtime_r(&secs, &tm));
+    long year;
+    unsigned month, day;
+    days_to_civil(days, year, month, day);
+    ASSERT_EQ(tm.tm_year + 1900, year);
+    ASSERT_EQ(tm.tm_mon + 1, (int) month);
+    ASSERT_EQ(tm.tm_mday, (int) day);
+  }
+}
+
+TEST(TickDate, basic) {
+  TickDate const fmt;
+  ASSERT_EQ("1970-01-01", fmt(0));
+  ASSERT_EQ("1969-12-31", fmt(-1));
+  ASSERT_EQ("2000-02-29", fmt(11016));
+  ASSERT_EQ("0000-01-01", fmt(DAY_MIN));
+  ASSERT_EQ("9999-12-31", fmt(DAY_MAX));
+  ASSERT_EQ("####-##-##", fmt(DAY_MIN - 1));
+  ASSERT_EQ("####-##-##", fmt(DAY_MAX + 1));
+  ASSERT_EQ("NaT       ", fmt(TickDate::NAT_VALUE));
+}
+
+TEST(TickTime, basic) {
+  TickTime const fmt(TickTime::SCALE_SEC);
+  ASSERT_EQ("1970-01-01T00:00:00+00:00", fmt(0));
+  ASSERT_EQ("1969-12-31T23:59:59+00:00", fmt(-1));
+  ASSERT_EQ("2001-09-09T01:46:40+00:00", fmt(1000000000));
+  ASSERT_EQ("9999-12-31T23:59:59+00:00", fmt(253402300799));
+  ASSERT_EQ("#########################", fmt(253402300800));
+  ASSERT_EQ("0000-01-01T00:00:00+00:00", fmt(-62167219200));
+  ASSERT_EQ("#########################", fmt(-62167219201));
+  ASSERT_EQ("NaT                      ", fmt(TickTime::NAT_VALUE));
+}
+
+TEST(TickTime, precision) {
+  TickTime const ms(TickTime::SCALE_NSEC, 3);
+  ASSERT_EQ("1970-01-01T00:00:00.000+00:00", ms(0));
+  ASSERT_EQ("1970-01-01T00:00:00.001+00:00", ms(999999));
+  ASSERT_EQ("1969-12-31T23:59:59.999+00:00", ms(-1000000));
+  ASSERT_EQ("1970-01-01T00:00:00.000+00:00", ms(-1));
+
+  // Precision zero shows the decimal point only, as for numbers.
+  TickTime const s(TickTime::SCALE_MSEC, 0);
+  ASSERT_EQ(26u, s.get_width());
+  ASSERT_EQ("1970-01-01T00:00:01.+00:00", s(1499));
+
+  TickTime const ns(TickTime::SCALE_USEC, 9);
+  ASSERT_EQ("1970-01-01T00:00:01.000002000+00:00", ns(1000002));
+  ASSERT_EQ("1969-12-31T23:59:59.999999000+00:00", ns(-1));
+}
+
+TEST(TickTime, batch) {
+  TickTime const fmt(TickTime::SCALE_MSEC, 3);
+  long const vals[] = {0, -1, 1500000000123, TickTime::NAT_VALUE};
+  int const width = fmt.get_width();
+  std::vector<char> buf(4 * width);
+  char* pos[4];
+  for (int i = 0; i < 4; ++i)
+    pos[i] = &buf[i * width];
+  fmt.format(vals, 4, pos);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(buf.data() + (i + 1) * width, pos[i]);
+    ASSERT_EQ(fmt(vals[i]), std::string(&buf[i * width], width));
+  }
+  ASSERT_EQ(
+    "2017-07-14T02:40:00.123+00:00", std::string(&buf[2 * width], width));
+}
+
+TEST(TickTime, sorted) {
+  // Sorted values crossing minute, hour, day boundaries, with repeats, NaT,
+  // and out of range values; and the same values unsorted.
+  std::vector<long> vals = {
+    -86401000, -1000, -1, 0, 0, 59999, 60000, 3599999, 3600000, 86399999,
+    86400000, 86400001, TickTime::NAT_VALUE, 1500000000123, 1500000059999,
+    1500000060000, 253402300799999, 253402300800000,
+    86400000, 0, 1500000000123, -1000, 253402300800000, 59999,
+  };
+  long const num = vals.size();
+
+  for (int precision : {TickTime::PRECISION_NONE, 0, 3, 6}) {
+    TickTime const fmt(TickTime::SCALE_MSEC, precision);
+    int const width = fmt.get_width();
+    std::vector<char> buf(num * width);
+    std::vector<char*> pos(num);
+    for (long i = 0; i < num; ++i)
+      pos[i] = &buf[i * width];
+    fmt.format(vals.data(), num, pos.data(), true);
+    for (long i = 0; i < num; ++i) {
+      ASSERT_EQ(buf.data() + (i + 1) * width, pos[i]);
+      ASSERT_EQ(fmt(vals[i]), std::string(&buf[i * width], width));
+    }
+  }
+}
+
+TEST(TickTime, sorted_column) {
+  // A time-ordered column, with NaTs, takes the sorted path by block.
+  long const length = 5000;
+  std::vector<long> vals(length);
+  for (long i = 0; i < length; ++i)
+    vals[i] = i % 97 == 0 ? TickTime::NAT_VALUE : 1500000000000 + i * 7919;
+  TickTime const fmt(TickTime::SCALE_MSEC, 3);
+  ColumnImpl<long, TickTime> const col(vals.data(), length, fmt);
+  std::vector<char> buf(length * fmt.get_max_bytes());
+  std::vector<char*> pos(length);
+  for (long i = 0; i < length; ++i)
+    pos[i] = &buf[i * fmt.get_max_bytes()];
+  col.format(0, length, pos.data());
+  for (long i = 0; i < length; ++i)
+    ASSERT_EQ(
+      fmt(vals[i]), std::string(&buf[i * fmt.get_max_bytes()], pos[i]));
+}
+
+TEST(TickTime, multibyte_nat) {
+  TickTime const fmt(
+    TickTime::SCALE_SEC, TickTime::PRECISION_NONE, "—");
+  std::string const nat = "—" + std::string(24, ' ');
+  ASSERT_EQ(nat, fmt(TickTime::NAT_VALUE));
+  ASSERT_EQ(nat.size(), fmt.get_max_bytes());
+  ASSERT_EQ(string_length(nat), fmt.get_width());
+
+  long const vals[] = {0, TickTime::NAT_VALUE, 60};
+  for (bool sorted : {false, true}) {
+    std::vector<char> buf(3 * fmt.get_max_bytes());
+    char* pos[3];
+    for (int i = 0; i < 3; ++i)
+      pos[i] = &buf[i * fmt.get_max_bytes()];
+    fmt.format(vals, 3, pos, sorted);
+    for (int i = 0; i < 3; ++i) {
+      char const* const start = &buf[i * fmt.get_max_bytes()];
+      ASSERT_EQ(fmt(vals[i]), std::string(start, (char const*) pos[i]));
+    }
+  }
+}
+
+TEST(TickDate, table) {
+  TickDate const plain;
+  ASSERT_GT(plain.get_min_val(), plain.get_max_val());
+
+  TickDate const fmt(-10, 1000);
+  ASSERT_EQ(-10, fmt.get_min_val());
+  ASSERT_EQ(1000, fmt.get_max_val());
+  for (long day = -100; day < 1100; ++day)
+    ASSERT_EQ(plain(day), fmt(day));
+  ASSERT_EQ("NaT       ", fmt(TickDate::NAT_VALUE));
+
+  // Clipped to the four-digit years.
+  TickDate const end(DAY_MAX - 5, DAY_MAX + 100);
+  ASSERT_EQ(DAY_MAX, end.get_max_val());
+  ASSERT_EQ("9999-12-31", end(DAY_MAX));
+  ASSERT_EQ("####-##-##", end(DAY_MAX + 1));
+  ASSERT_EQ("NaT       ", end(TickDate::NAT_VALUE));
+  ASSERT_EQ("####-##-##", fmt(std::numeric_limits<long>::max()));
+
+  // Too many days for a table.
+  TickDate const big(0, TickDate::TABLE_MAX_SIZE);
+  ASSERT_GT(big.get_min_val(), big.get_max_val());
+  ASSERT_EQ("2000-02-29", big(11016));
+}
+
+TEST(TickDate, units) {
+  TickDate const week(1, 0, TickDate::UNIT_WEEK);
+  ASSERT_EQ(10, (int) week.get_width());
+  ASSERT_EQ("1970-01-01", week(0));
+  ASSERT_EQ("1969-12-25", week(-1));
+  ASSERT_EQ("2000-08-31", week(1600));
+
+  TickDate const month(-2, 30, TickDate::UNIT_MONTH);
+  ASSERT_EQ(7, (int) month.get_width());
+  ASSERT_EQ("1970-01", month(0));
+  ASSERT_EQ("1969-12", month(-1));
+  ASSERT_EQ("1968-01", month(-24));
+  ASSERT_EQ("2020-02", month(601));
+  ASSERT_EQ("0000-01", month(-1970 * 12));
+  ASSERT_EQ("####-##", month(-1970 * 12 - 1));
+  ASSERT_EQ("9999-12", month((9999 - 1970) * 12 + 11));
+  ASSERT_EQ("####-##", month((9999 - 1970) * 12 + 12));
+
+  TickDate const year(0, 100, TickDate::UNIT_YEAR);
+  ASSERT_EQ(4, (int) year.get_width());
+  ASSERT_EQ("1970", year(0));
+  ASSERT_EQ("1969", year(-1));
+  ASSERT_EQ("0000", year(-1970));
+  ASSERT_EQ("####", year(-1971));
+  ASSERT_EQ("9999", year(8029));
+  ASSERT_EQ("####", year(8030));
+  ASSERT_EQ("NaT ", year(TickDate::NAT_VALUE));
+  ASSERT_EQ("NaT    ", month(TickDate::NAT_VALUE));
+  ASSERT_EQ("NaT       ", week(TickDate::NAT_VALUE));
+}
+
+TEST(TickDate, nat) {
+  TickDate const fmt(0, 10, TickDate::UNIT_DAY, "—");
+  ASSERT_EQ("—         ", fmt(TickDate::NAT_VALUE));
+  ASSERT_EQ(12u, fmt.get_max_bytes());
+  std::vector<long> const vals = {0, TickDate::NAT_VALUE, 1};
+  std::string buf(3 * fmt.get_max_bytes(), ' ');
+  std::vector<char*> pos = {&buf[0], &buf[12], &buf[24]};
+  char* const starts[] = {pos[0], pos[1], pos[2]};
+  fmt.format(vals.data(), 3, pos.data());
+  ASSERT_EQ("—         ", std::string(starts[1], pos[1]));
+  ASSERT_EQ("1970-01-02", std::string(starts[2], pos[2]));
+}
+
+TEST(TickTime, period) {
+  TickTime const min(TickTime::SCALE_SEC, -1, "NaT", TickTime::PERIOD_MIN);
+  ASSERT_EQ("1970-01-01T00:01:00+00:00", min(1));
+  ASSERT_EQ("1969-12-31T23:59:00+00:00", min(-1));
+  ASSERT_EQ("#########################", min(1l << 60));
+  ASSERT_EQ("NaT                      ", min(TickTime::NAT_VALUE));
+
+  TickTime const hour(TickTime::SCALE_SEC, 3, "NaT", TickTime::PERIOD_HOUR);
+  ASSERT_EQ("1970-01-02T01:00:00.000+00:00", hour(25));
+  ASSERT_EQ("#############################", hour(-(1l << 60)));
+}
+
+TEST(TickTime, fine) {
+  TickTime const as(TickTime::SCALE_ASEC, 18);
+  ASSERT_EQ("1970-01-01T00:00:01.000000000000000001+00:00", as(TickTime::SCALE_ASEC + 1));
+  ASSERT_EQ("1969-12-31T23:59:59.999999999999999999+00:00", as(-1));
+  TickTime const ps(TickTime::SCALE_PSEC, 9);
+  ASSERT_EQ("1970-01-01T00:00:00.000000001+00:00", ps(1000));
+  ASSERT_EQ("1970-01-01T00:00:00.000000001+00:00", ps(500));
+  ASSERT_EQ("1970-01-01T00:00:00.000000000+00:00", ps(499));
+  // Rounding would overflow.
+  ASSERT_EQ("###################################", ps(9223372036854775807l));
+}
+
+TEST(TickTime, pattern) {
+  long const val = 1500000000123;  // 2017-07-14T02:40:00.123Z
+
+  TickTime const space(
+    TickTime::SCALE_MSEC, 3, "NaT", TickTime::PERIOD_SEC, nullptr,
+    "%Y-%m-%d %H:%M:%S%f");
+  ASSERT_EQ(23, space.get_width());
+  ASSERT_EQ("2017-07-14 02:40:00.123", space(val));
+  ASSERT_EQ("NaT                    ", space(TickTime::NAT_VALUE));
+
+  TickTime const zulu(
+    TickTime::SCALE_MSEC, TickTime::PRECISION_NONE, "NaT",
+    TickTime::PERIOD_SEC, nullptr, "%Y-%m-%dT%H:%M:%SZ");
+  ASSERT_EQ("2017-07-14T02:40:00Z", zulu(val));
+  ASSERT_EQ("####################", zulu(253402300800000));
+
+  TickTime const clock(
+    TickTime::SCALE_MSEC, 0, "NaT", TickTime::PERIOD_SEC,
+    std::make_shared<TimeZone>(-9000), "%H:%M:%S%f %z %%");
+  ASSERT_EQ("00:10:00. -02:30 %", clock(val));
+  ASSERT_EQ("21:29:59. -02:30 %", clock(-1000));
+
+  TickTime const literal(
+    TickTime::SCALE_SEC, TickTime::PRECISION_NONE, "NaT",
+    TickTime::PERIOD_SEC, nullptr, "day %d of %m/%Y");
+  ASSERT_EQ("day 14 of 07/2017", literal(1500000000));
+
+  ASSERT_THROW(
+    TickTime(1, -1, "NaT", 1, nullptr, "%Y-%q"), TickTime::Error);
+  ASSERT_THROW(
+    TickTime(1, -1, "NaT", 1, nullptr, "%H:%M:%"), TickTime::Error);
+}
+
+TEST(TickTime, pattern_sorted) {
+  std::vector<long> vals = {
+    -86401000, -1000, 0, 59999, 60000, 86400001, TickTime::NAT_VALUE,
+    1500000000123, 1500000060000, 0, 1500000000123, 59999,
+  };
+  long const num = vals.size();
+
+  for (auto pattern : {
+      "%H:%M:%S%f", "%Y-%m-%d %H:%M", "%S%f %d/%m/%Y %H:%M", "%z%fZ"}) {
+    TickTime const fmt(
+      TickTime::SCALE_MSEC, 3, "NaT", TickTime::PERIOD_SEC,
+      std::make_shared<TimeZone>(3600), pattern);
+    int const width = fmt.get_width();
+    std::vector<char> buf(num * width);
+    std::vector<char*> pos(num);
+    for (long i = 0; i < num; ++i)
+      pos[i] = &buf[i * width];
+    fmt.format(vals.data(), num, pos.data(), true);
+    for (long i = 0; i < num; ++i) {
+      ASSERT_EQ(buf.data() + (i + 1) * width, pos[i]);
+      ASSERT_EQ(fmt(vals[i]), std::string(&buf[i * width], width));
+    }
+  }
+}
+
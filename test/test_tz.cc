@@ -0,0 +1,116 @@
+#include <string>
+#include <vector>
+
+#include "fixfmt.hh"
+#include "gtest/gtest.h"
+
+using namespace fixfmt;
+
+namespace {
+
+long constexpr HOUR = 3600;
+
+// Seconds since the epoch of a UTC date and time.
+long
+utc(
+  long const year,
+  unsigned const month,
+  unsigned const day,
+  long const hour=0)
+{
+  return civil_to_days(year, month, day) * 86400 + hour * HOUR;
+}
+
+}  // anonymous namespace
+
+TEST(civil_to_days, round_trip) {
+  for (long days = DAY_MIN; days <= DAY_MAX; days += 13) {
+    long year;
+    unsigned month, day;
+    days_to_civil(days, year, month, day);
+    ASSERT_EQ(days, civil_to_days(year, month, day));
+  }
+}
+
+TEST(TimeZone, fixed) {
+  TimeZone const tz(5 * HOUR + 1800);
+  ASSERT_EQ("+05:30", tz.get_name());
+  ASSERT_EQ(19800, tz.get_offset(0));
+  ASSERT_EQ(19800, tz.get_offset(utc(2100, 7, 1)));
+  ASSERT_EQ("-03:00", TimeZone(-3 * HOUR).get_name());
+}
+
+TEST(TimeZone, new_york) {
+  auto const tz = TimeZone::load("America/New_York");
+  ASSERT_EQ("America/New_York", tz->get_name());
+
+  // DST started at 02:00 EST and ended at 02:00 EDT.
+  ASSERT_EQ(-5 * HOUR, tz->get_offset(utc(2020, 3, 8, 7) - 1));
+  ASSERT_EQ(-4 * HOUR, tz->get_offset(utc(2020, 3, 8, 7)));
+  ASSERT_EQ(-4 * HOUR, tz->get_offset(utc(2020, 11, 1, 6) - 1));
+  ASSERT_EQ(-5 * HOUR, tz->get_offset(utc(2020, 11, 1, 6)));
+  // Before 2007, DST started in April.
+  ASSERT_EQ(-5 * HOUR, tz->get_offset(utc(2000, 3, 20)));
+  ASSERT_EQ(-4 * HOUR, tz->get_offset(utc(2000, 4, 20)));
+  // Local mean time, before standard time.
+  ASSERT_EQ(-17762, tz->get_offset(utc(1850, 1, 1)));
+  // From the rule, past any precomputed transitions.
+  ASSERT_EQ(-4 * HOUR, tz->get_offset(utc(2500, 3, 14, 7)));
+  ASSERT_EQ(-5 * HOUR, tz->get_offset(utc(2500, 3, 14, 7) - 1));
+  ASSERT_EQ(-5 * HOUR, tz->get_offset(utc(2500, 12, 25)));
+}
+
+TEST(TimeZone, southern) {
+  auto const tz = TimeZone::load("Australia/Sydney");
+  ASSERT_EQ(11 * HOUR, tz->get_offset(utc(2021, 1, 1)));
+  ASSERT_EQ(10 * HOUR, tz->get_offset(utc(2021, 7, 1)));
+  ASSERT_EQ(11 * HOUR, tz->get_offset(utc(2300, 1, 1)));
+  ASSERT_EQ(10 * HOUR, tz->get_offset(utc(2300, 7, 1)));
+  ASSERT_EQ(11 * HOUR, tz->get_offset(utc(2300, 12, 31)));
+}
+
+TEST(TimeZone, cursor) {
+  auto const tz = TimeZone::load("Europe/London");
+  TimeZone::Cursor cursor(*tz);
+  // Sorted, then unsorted.
+  for (long time = utc(1900, 1, 1); time < utc(2200, 1, 1); time += 7 * HOUR)
+    ASSERT_EQ(tz->get_offset(time), cursor.get_offset(time));
+  for (long time = utc(2200, 1, 1); time > utc(1900, 1, 1); time -= 11 * HOUR)
+    ASSERT_EQ(tz->get_offset(time), cursor.get_offset(time));
+}
+
+TEST(TimeZone, errors) {
+  ASSERT_THROW(TimeZone::load("Not/A_Zone"), TimeZone::Error);
+  ASSERT_THROW(TimeZone::load("../../etc/passwd"), TimeZone::Error);
+  ASSERT_THROW(TimeZone::parse("bad", "TZif"), TimeZone::Error);
+  ASSERT_THROW(TimeZone::parse("bad", "not a tzfile"), TimeZone::Error);
+}
+
+TEST(TickTime, tz) {
+  TickTime const fmt(
+    TickTime::SCALE_SEC, 0, "NaT", TickTime::PERIOD_SEC,
+    TimeZone::load("America/New_York"));
+  long const t = utc(2020, 3, 8, 7);
+  ASSERT_EQ("2020-03-08T01:59:59.-05:00", fmt(t - 1));
+  ASSERT_EQ("2020-03-08T03:00:00.-04:00", fmt(t));
+
+  // The sorted batch path, across the transition.
+  std::vector<long> vals;
+  for (long v = t - 2 * HOUR; v < t + 2 * HOUR; v += 599)
+    vals.push_back(v);
+  long const num = vals.size();
+  int const width = fmt.get_width();
+  std::vector<char> buf(num * width);
+  std::vector<char*> pos(num);
+  for (long i = 0; i < num; ++i)
+    pos[i] = &buf[i * width];
+  fmt.format(vals.data(), num, pos.data(), true);
+  for (long i = 0; i < num; ++i)
+    ASSERT_EQ(fmt(vals[i]), std::string(&buf[i * width], width));
+
+  TickTime const india(
+    TickTime::SCALE_SEC, -1, "NaT", TickTime::PERIOD_SEC,
+    std::make_shared<TimeZone>(5 * HOUR + 1800));
+  ASSERT_EQ("1970-01-01T05:30:00+05:30", india(0));
+}
+